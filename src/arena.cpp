@@ -0,0 +1,117 @@
+module;
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+
+export module nhtypes:arena;
+
+import :common;
+import :integers;
+
+namespace NH_NAMESPACE {
+
+    // Twice as wide as size_t, so count * ElementSize + padding + used can't wrap:
+    // (2^n - 1)^2 + 2 * (2^n - 1) < 2^2n.
+#if defined(__SIZEOF_INT128__)
+    using ArenaWide = uint128_t;
+#else
+    using ArenaWide = uint64_t;
+    static_assert(sizeof(size_t) < sizeof(ArenaWide), "SafeArena needs an integer twice as wide as size_t");
+#endif
+}
+
+export namespace NH_NAMESPACE {
+
+    // Bump allocator over a caller owned buffer. Size, alignment padding and capacity of an
+    // allocation are computed in a wide type and checked with a single comparison.
+    // Memory is only given back all at once by reset(), destructors are never run.
+    struct SafeArena
+    {
+        explicit SafeArena(std::span<std::byte> buffer) noexcept : m_buffer(buffer.data()), m_capacity(buffer.size()) {}
+
+        SafeArena(SafeArena const &) = delete;
+        SafeArena & operator=(SafeArena const &) = delete;
+
+        // Uninitialized storage for count objects of T, throws std::bad_alloc if the arena is exhausted.
+        template <typename T>
+        T* allocate(SafeSize count = 1) {
+            return static_cast<T*>(orThrow(allocateBytes<sizeof(T)>(+count, alignof(T))));
+        }
+
+        // Batch allocation, constructs count objects from the same arguments with one check.
+        template <typename T, typename... Args>
+        std::span<T> create(SafeSize count, Args const &... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "SafeArena never runs destructors");
+            T* objects = allocate<T>(count);
+            for (size_t i = 0; i < +count; ++i)
+                std::construct_at(objects + i, args...);
+            return { objects, +count };
+        }
+
+        // Runtime alignment, used by the memory_resource adapter. Must be a power of two.
+        void* allocate(SafeSize size, SafeSize alignment) {
+            Assert(std::has_single_bit(+alignment));
+            return orThrow(allocateBytes<1>(+size, +alignment));
+        }
+
+        void reset() noexcept { m_used = 0; }
+
+        SafeSize used() const noexcept { return m_used; }
+        SafeSize capacity() const noexcept { return m_capacity; }
+        SafeSize remaining() const noexcept { return m_capacity - m_used; }
+
+    private:
+        // Exhaustion is a runtime condition rather than a bug, so it is reported in release builds too.
+        static void* orThrow(void* pointer) {
+            if (!pointer)
+                throw std::bad_alloc();
+            return pointer;
+        }
+
+        // Null if the allocation doesn't fit, the arena is left unchanged in that case.
+        template <size_t ElementSize>
+        void* allocateBytes(size_t count, size_t alignment) {
+            const uintptr_t current = reinterpret_cast<uintptr_t>(m_buffer) + m_used;
+            const size_t padding = static_cast<size_t>(0 - current) & (alignment - 1);
+            const ArenaWide end = static_cast<ArenaWide>(count) * ElementSize + padding + m_used;
+            if (end > m_capacity)
+                return nullptr;
+
+            std::byte * result = m_buffer + SafeSize(m_used + padding);
+            m_used = static_cast<size_t>(end);
+            return result;
+        }
+
+        std::byte * m_buffer;
+        size_t m_capacity;
+        size_t m_used = 0;
+    };
+
+    // std::pmr adapter, deallocation is a no-op until the arena is reset.
+    // Throws std::bad_alloc when the arena is exhausted, as memory_resource requires.
+    struct SafeArenaResource : std::pmr::memory_resource
+    {
+        explicit SafeArenaResource(SafeArena & arena) noexcept : m_arena(arena) {}
+
+        SafeArena & arena() const noexcept { return m_arena; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            return m_arena.allocate(SafeSize(bytes), SafeSize(alignment));
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override {
+            return this == &other;
+        }
+
+        SafeArena & m_arena;
+    };
+}
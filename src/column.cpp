@@ -0,0 +1,182 @@
+module;
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module nhtypes:column;
+
+import :common;
+import :integers;
+
+namespace NH_NAMESPACE {
+
+    template <typename Wide, typename IntType>
+    constexpr inline bool isInRange(Wide value) {
+        return value >= static_cast<Wide>(std::numeric_limits<IntType>::min()) &&
+               value <= static_cast<Wide>(std::numeric_limits<IntType>::max());
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    template <typename T>
+    struct SafeColumn;
+
+    // Column of SafeInt values stored as a plain array plus a min/max per block.
+    // Kernels use the block bounds to prove an operation can't overflow and only
+    // fall back to per element checks for blocks where they can't.
+    template <typename IntType>
+    struct SafeColumn<SafeInt<IntType>>
+    {
+        using ValueType = SafeInt<IntType>;
+        using CType = IntType;
+
+        static constexpr size_t BlockSize = 1024;
+
+        struct ZoneMap {
+            IntType min;
+            IntType max;
+        };
+
+        void push_back(ValueType value) {
+            const IntType raw = +value;
+            if (m_values.size() % BlockSize == 0) {
+                m_zones.push_back({ raw, raw });
+            } else {
+                ZoneMap & zone = m_zones.back();
+                zone.min = raw < zone.min ? raw : zone.min;
+                zone.max = raw > zone.max ? raw : zone.max;
+            }
+            m_values.push_back(raw);
+        }
+
+        // Only widens the block bounds, they stay conservative after overwrites.
+        void set(size_t index, ValueType value) {
+            Assert(index < m_values.size());
+            const IntType raw = +value;
+            ZoneMap & zone = m_zones[index / BlockSize];
+            zone.min = raw < zone.min ? raw : zone.min;
+            zone.max = raw > zone.max ? raw : zone.max;
+            m_values[index] = raw;
+        }
+
+        ValueType operator[](size_t index) const {
+            Assert(index < m_values.size());
+            return ValueType(m_values[index]);
+        }
+
+        size_t size() const { return m_values.size(); }
+        bool empty() const { return m_values.empty(); }
+        void reserve(size_t count) { m_values.reserve(count); m_zones.reserve(count / BlockSize + 1); }
+
+        size_t blockCount() const { return m_zones.size(); }
+        ZoneMap const & zone(size_t block) const { return m_zones[block]; }
+        const IntType * data() const { return m_values.data(); }
+
+        ValueType sum() const {
+            using Wide = WideIntType<IntType>;
+
+            ValueType result = 0;
+            for (size_t block = 0; block < m_zones.size(); ++block) {
+                const size_t begin = block * BlockSize;
+                const size_t end = begin + blockLength(block);
+
+                if constexpr (!std::is_void_v<Wide>) {
+                    const Wide count = static_cast<Wide>(end - begin);
+                    const Wide current = +result;
+                    const bool canOverflow {
+                        !isInRange<Wide, IntType>(current + count * m_zones[block].min) ||
+                        !isInRange<Wide, IntType>(current + count * m_zones[block].max)
+                    };
+
+                    if (!canOverflow) {
+                        IntType partial = +result;
+                        for (size_t i = begin; i < end; ++i)
+                            partial += m_values[i];
+                        result = ValueType(partial);
+                        continue;
+                    }
+                }
+
+                for (size_t i = begin; i < end; ++i)
+                    result += ValueType(m_values[i]);
+            }
+            return result;
+        }
+
+        // Multiplies every value in place.
+        void scale(ValueType factor) {
+            using Wide = WideIntType<IntType>;
+
+            const IntType raw = +factor;
+            for (size_t block = 0; block < m_zones.size(); ++block) {
+                const size_t begin = block * BlockSize;
+                const size_t end = begin + blockLength(block);
+                ZoneMap & zone = m_zones[block];
+
+                if constexpr (!std::is_void_v<Wide>) {
+                    const Wide first = static_cast<Wide>(zone.min) * raw;
+                    const Wide second = static_cast<Wide>(zone.max) * raw;
+
+                    if (isInRange<Wide, IntType>(first) && isInRange<Wide, IntType>(second)) {
+                        for (size_t i = begin; i < end; ++i)
+                            m_values[i] = static_cast<IntType>(m_values[i] * raw);
+                        zone.min = static_cast<IntType>(first < second ? first : second);
+                        zone.max = static_cast<IntType>(first < second ? second : first);
+                        continue;
+                    }
+                }
+
+                // The bounds may be stale after set(), so recompute them from the scaled values.
+                zone = { IntType(+(ValueType(m_values[begin]) * factor)), IntType(+(ValueType(m_values[begin]) * factor)) };
+                for (size_t i = begin; i < end; ++i) {
+                    m_values[i] = +(ValueType(m_values[i]) * factor);
+                    zone.min = m_values[i] < zone.min ? m_values[i] : zone.min;
+                    zone.max = m_values[i] > zone.max ? m_values[i] : zone.max;
+                }
+            }
+        }
+
+        // Converts to a column of a smaller type, asserts if any value doesn't fit.
+        template <typename Other>
+        SafeColumn<SafeInt<Other>> narrow() const {
+            SafeColumn<SafeInt<Other>> result;
+            result.m_values.resize(m_values.size());
+            result.m_zones.resize(m_zones.size());
+
+            for (size_t block = 0; block < m_zones.size(); ++block) {
+                const size_t begin = block * BlockSize;
+                const size_t end = begin + blockLength(block);
+                ZoneMap zone = m_zones[block];
+
+                if (!std::in_range<Other>(zone.min) || !std::in_range<Other>(zone.max)) {
+                    // The bounds may be stale after set(), so tighten them from the values.
+                    zone = { m_values[begin], m_values[begin] };
+                    for (size_t i = begin; i < end; ++i) {
+                        Assert(std::in_range<Other>(m_values[i]));
+                        zone.min = m_values[i] < zone.min ? m_values[i] : zone.min;
+                        zone.max = m_values[i] > zone.max ? m_values[i] : zone.max;
+                    }
+                }
+
+                for (size_t i = begin; i < end; ++i)
+                    result.m_values[i] = static_cast<Other>(m_values[i]);
+                result.m_zones[block] = { static_cast<Other>(zone.min), static_cast<Other>(zone.max) };
+            }
+            return result;
+        }
+
+    private:
+        template <typename> friend struct SafeColumn;
+
+        size_t blockLength(size_t block) const {
+            const size_t begin = block * BlockSize;
+            return m_values.size() - begin < BlockSize ? m_values.size() - begin : BlockSize;
+        }
+
+        std::vector<IntType> m_values;
+        std::vector<ZoneMap> m_zones;
+    };
+}
@@ -3,6 +3,7 @@ module;
 #include <cstdint>
 #include <cstddef>
 #include <cassert>
+#include <type_traits>
 
 export module nhtypes:common;
 
@@ -21,6 +22,31 @@ export namespace NH_NAMESPACE {
     using size_t = std::size_t;
 }
 
+namespace NH_NAMESPACE {
+
+#if defined(__SIZEOF_INT128__)
+    using int128_t = __int128;
+    using uint128_t = unsigned __int128;
+#endif
+
+    // Integer with at least twice the bits of IntType and the same signedness, so it holds
+    // any product of two IntType values. Void if the platform has none.
+    template <typename IntType>
+    struct WideInt {
+        using type = std::conditional_t<(sizeof(IntType) < sizeof(int64_t)),
+            std::conditional_t<std::is_signed_v<IntType>, int64_t, uint64_t>,
+#if defined(__SIZEOF_INT128__)
+            std::conditional_t<std::is_signed_v<IntType>, int128_t, uint128_t>
+#else
+            void
+#endif
+        >;
+    };
+
+    template <typename IntType>
+    using WideIntType = typename WideInt<IntType>::type;
+}
+
 namespace NH_NAMESPACE {
 
     void DebugBreak()
@@ -36,7 +62,9 @@ namespace NH_NAMESPACE {
 #endif
     }
 
-    export inline void Assert(bool condition) { 
+    // constexpr so checked values can be built in constant expressions, a failing
+    // assertion there is a compile error.
+    export constexpr inline void Assert(bool condition) { 
             if(!condition) [[unlikely]]{
 #if ENABLE_TESTABLE_ASSERTIONS
                 throw 1;
@@ -1,8 +1,20 @@
 module;
 
+#include <bit>
 #include <functional>
 #include <limits>
 #include <cmath>
+#include <span>
+#include <type_traits>
+
+#if __has_include(<stdfloat>)
+#   include <stdfloat>
+#endif
+
+#if defined(HAS_HALF_DECIMAL) && (defined(__x86_64__) || defined(__i386__))
+#   include <immintrin.h>
+#   define HAS_F16C_KERNELS 1
+#endif
 
 export module nhtypes:decimals;
 
@@ -19,12 +31,91 @@ namespace NH_NAMESPACE {
     friend Type operator/(Type lhs, Type rhs) { lhs /= rhs; return lhs; } 
 
 
+#if defined(__STDCPP_FLOAT16_T__)
+using HalfType = std::float16_t;
+#elif defined(HAS_HALF_DECIMAL)
+using HalfType = _Float16;
+#endif
+
+#if defined(__STDCPP_BFLOAT16_T__)
+using BFloat16Type = std::bfloat16_t;
+#elif defined(HAS_BFLOAT16_DECIMAL)
+using BFloat16Type = __bf16;
+#endif
+
+// numeric_limits, filled in from the compiler's macros for extended types the library doesn't know.
+// Values are built from the exponents since not every compiler accepts the F16/BF16 literals in C++.
+constexpr inline float exactPowerOfTwo(int exponent) noexcept
+{
+    float result = 1.0f;
+    for (; exponent > 0; --exponent) result *= 2.0f;
+    for (; exponent < 0; ++exponent) result /= 2.0f;
+    return result;
+}
+
+template <typename FloatingPointType>
+struct DecimalLimits : std::numeric_limits<FloatingPointType> {};
+
+#define EXTENDED_DECIMAL_LIMITS(Type, Prefix)                                                   \
+    template <>                                                                                 \
+    struct DecimalLimits<Type> {                                                                \
+        static constexpr bool is_specialized = true;                                            \
+        static constexpr bool is_signed = true;                                                 \
+        static constexpr bool is_integer = false;                                               \
+        static constexpr bool is_exact = false;                                                 \
+        static constexpr bool has_infinity = true;                                              \
+        static constexpr bool has_quiet_NaN = true;                                             \
+        static constexpr bool has_signaling_NaN = true;                                         \
+        static constexpr bool is_iec559 = true;                                                 \
+        static constexpr bool is_bounded = true;                                                \
+        static constexpr bool is_modulo = false;                                                \
+        static constexpr bool traps = false;                                                    \
+        static constexpr bool tinyness_before = false;                                          \
+        static constexpr std::float_denorm_style has_denorm = std::denorm_present;              \
+        static constexpr bool has_denorm_loss = false;                                          \
+        static constexpr std::float_round_style round_style = std::round_to_nearest;            \
+        static constexpr int digits = __##Prefix##_MANT_DIG__;                                  \
+        static constexpr int digits10 = __##Prefix##_DIG__;                                     \
+        static constexpr int max_digits10 = __##Prefix##_DECIMAL_DIG__;                         \
+        static constexpr int radix = 2;                                                         \
+        static constexpr int min_exponent = __##Prefix##_MIN_EXP__;                             \
+        static constexpr int min_exponent10 = __##Prefix##_MIN_10_EXP__;                        \
+        static constexpr int max_exponent = __##Prefix##_MAX_EXP__;                             \
+        static constexpr int max_exponent10 = __##Prefix##_MAX_10_EXP__;                        \
+        static constexpr Type min() noexcept { return static_cast<Type>(exactPowerOfTwo(min_exponent - 1)); }      \
+        static constexpr Type max() noexcept { return static_cast<Type>((2.0f - exactPowerOfTwo(1 - digits)) * exactPowerOfTwo(max_exponent - 1)); } \
+        static constexpr Type lowest() noexcept { return -max(); }                              \
+        static constexpr Type epsilon() noexcept { return static_cast<Type>(exactPowerOfTwo(1 - digits)); }        \
+        static constexpr Type round_error() noexcept { return static_cast<Type>(0.5f); }        \
+        static constexpr Type denorm_min() noexcept { return static_cast<Type>(exactPowerOfTwo(min_exponent - digits)); } \
+        static constexpr Type infinity() noexcept { return static_cast<Type>(__builtin_huge_valf()); } \
+        static constexpr Type quiet_NaN() noexcept { return static_cast<Type>(__builtin_nanf("")); }   \
+        static constexpr Type signaling_NaN() noexcept { return static_cast<Type>(__builtin_nansf("")); } \
+    };
+
+#if defined(HAS_HALF_DECIMAL) && !defined(__STDCPP_FLOAT16_T__)
+EXTENDED_DECIMAL_LIMITS(_Float16, FLT16)
+#endif
+#if defined(HAS_BFLOAT16_DECIMAL) && !defined(__STDCPP_BFLOAT16_T__)
+EXTENDED_DECIMAL_LIMITS(__bf16, BFLT16)
+#endif
+
 template <typename FloatingPointType>
 constexpr inline bool isInfinityOrNan(FloatingPointType value) noexcept
 { 
-    return (fabs(value) == std::numeric_limits<FloatingPointType>::infinity()) || std::isnan(value);
+    // Half precision types are widened first, float represents all of their values exactly.
+    if constexpr (sizeof(FloatingPointType) < sizeof(float))
+        return isInfinityOrNan(static_cast<float>(value));
+    else
+        return (fabs(value) == std::numeric_limits<FloatingPointType>::infinity()) || std::isnan(value);
 }
 
+// True if every finite value of From is representable in To (e.g. half -> float, but not bfloat16 -> half).
+template <typename From, typename To>
+concept isLosslessDecimalConversion =
+    DecimalLimits<To>::digits >= DecimalLimits<From>::digits &&
+    DecimalLimits<To>::max_exponent >= DecimalLimits<From>::max_exponent;
+
 template <typename ValueType>
 struct DecimalBase
 {
@@ -33,10 +124,10 @@ struct DecimalBase
 
     ValueType m_value;
 
-    static constexpr ValueType Max = std::numeric_limits<ValueType>::max();
-    static constexpr ValueType Min = std::numeric_limits<ValueType>::min();
+    static constexpr ValueType Max = DecimalLimits<ValueType>::max();
+    static constexpr ValueType Min = DecimalLimits<ValueType>::min();
 
-    DecimalBase(ValueType value = 0) : m_value(value) {}
+    constexpr DecimalBase(ValueType value = 0) : m_value(value) {}
 };
 
 template <typename ValueType>
@@ -54,15 +145,22 @@ public:
     };
 
     template <typename Other>
-    requires (sizeof(Other) >= sizeof(ValueType))
-    inline constexpr operator SafeDecimal<Other>() { return m_value; }
+    requires isLosslessDecimalConversion<ValueType, Other>
+    inline constexpr operator SafeDecimal<Other>() const { return m_value; }
+
+    // Narrowing, asserts that the value did not overflow the smaller type.
+    template <typename Other>
+    requires (!isLosslessDecimalConversion<Other, ValueType>)
+    explicit constexpr SafeDecimal(SafeDecimal<Other> value) : Base(static_cast<ValueType>(+value)) {
+        Assert(!isInfinityOrNan(m_value));
+    }
 
     template <typename IntType>
-    requires(sizeof(IntType) * 8 <= std::numeric_limits<ValueType>::digits)
+    requires(sizeof(IntType) * 8 <= DecimalLimits<ValueType>::digits)
     constexpr SafeDecimal(SafeInt<IntType> value) : Base(+value) {}
 
     template <typename IntType>
-    requires(sizeof(IntType) * 8 >= std::numeric_limits<ValueType>::digits)
+    requires(sizeof(IntType) * 8 >= DecimalLimits<ValueType>::digits)
     constexpr operator SafeInt<IntType>() { return m_value; }
 
     // Assignemnt Operators
@@ -133,7 +231,7 @@ public:
 
 private:
 
-    static constexpr ValueType EPSILON = std::numeric_limits<ValueType>::epsilon();
+    static constexpr ValueType EPSILON = DecimalLimits<ValueType>::epsilon();
 
     static constexpr inline Bool safeCompare(ValueType first, ValueType second, ValueType maxDiff = EPSILON, ValueType maxRelDiff = EPSILON) noexcept 
     {
@@ -165,19 +263,23 @@ public:
     constexpr inline FastDecimal(ValueType value = 0) : Base(value) {}
     
     template <typename Other>
-    requires (sizeof(Other) >= sizeof(ValueType))
-    constexpr inline operator FastDecimal<Other>() { return m_value; }
+    requires isLosslessDecimalConversion<ValueType, Other>
+    constexpr inline operator FastDecimal<Other>() const { return m_value; }
+
+    template <typename Other>
+    requires isLosslessDecimalConversion<ValueType, Other>
+    constexpr inline operator SafeDecimal<Other>() const { return m_value; }
 
     template <typename Other>
-    requires (sizeof(Other) >= sizeof(ValueType))
-    constexpr inline operator SafeDecimal<Other>() { return m_value; }
+    requires (!isLosslessDecimalConversion<Other, ValueType>)
+    explicit constexpr FastDecimal(FastDecimal<Other> value) : Base(static_cast<ValueType>(+value)) {}
 
     template <typename IntType>
-    requires(sizeof(IntType) * 8 <= std::numeric_limits<ValueType>::digits)
+    requires(sizeof(IntType) * 8 <= DecimalLimits<ValueType>::digits)
     constexpr FastDecimal(FastInt<IntType> value) : Base(+value) {}
 
     template <typename IntType>
-    requires(sizeof(IntType) * 8 >= std::numeric_limits<ValueType>::digits)
+    requires(sizeof(IntType) * 8 >= DecimalLimits<ValueType>::digits)
     constexpr operator FastInt<IntType>() { return m_value; }
 
     constexpr inline Bool operator==(FastDecimal rhs) const noexcept { return m_value == rhs.m_value; }
@@ -223,6 +325,173 @@ export namespace NH_NAMESPACE
     using FastDouble = FastDecimal<double>;
     using SafeFloat = SafeDecimal<float>;
     using SafeDouble = SafeDecimal<double>;
+
+#if defined(HAS_HALF_DECIMAL)
+    using FastHalf = FastDecimal<HalfType>;
+    using SafeHalf = SafeDecimal<HalfType>;
+#endif
+
+#if defined(HAS_BFLOAT16_DECIMAL)
+    using FastBFloat16 = FastDecimal<BFloat16Type>;
+    using SafeBFloat16 = SafeDecimal<BFloat16Type>;
+#endif
+}
+
+namespace NH_NAMESPACE
+{
+    // Span conversions work on the raw values, both Safe types are a single member of the
+    // underlying type. Widening can't fail and is unchecked, narrowing collects one overflow
+    // flag for the whole span. Infinity has all exponent bits set in either narrow format.
+
+    template <typename Decimal>
+    inline auto rawData(std::span<Decimal> values)
+    {
+        using CType = typename std::remove_const_t<Decimal>::CType;
+        if constexpr (std::is_const_v<Decimal>)
+            return reinterpret_cast<const CType*>(values.data());
+        else
+            return reinterpret_cast<CType*>(values.data());
+    }
+
+    // Values that overflowed are reset before asserting, so dst never holds infinity.
+    template <typename Narrow>
+    inline void clearOverflow(Narrow* dst, size_t count, uint16_t exponentMask)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            if ((std::bit_cast<uint16_t>(dst[i]) & exponentMask) == exponentMask)
+                dst[i] = Narrow(0.0f);
+        }
+    }
+
+#if defined(HAS_HALF_DECIMAL)
+#if defined(HAS_F16C_KERNELS)
+    // Compiled for F16C regardless of the target flags and selected at runtime.
+    inline bool hasF16C()
+    {
+#if defined(__F16C__)
+        return true;
+#else
+        static const bool isSupported = __builtin_cpu_supports("f16c");
+        return isSupported;
+#endif
+    }
+
+    __attribute__((target("avx,f16c")))
+    inline void widenHalfF16C(const HalfType* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+        }
+        for (; i < count; ++i)
+            dst[i] = static_cast<float>(src[i]);
+    }
+
+    __attribute__((target("avx,f16c")))
+    inline bool narrowHalfF16C(const float* src, HalfType* dst, size_t count)
+    {
+        const __m128i exponentMask = _mm_set1_epi16(0x7C00);
+        __m128i overflow = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            overflow = _mm_or_si128(overflow, _mm_cmpeq_epi16(_mm_and_si128(half, exponentMask), exponentMask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), half);
+        }
+        bool didOverflow = _mm_movemask_epi8(overflow) != 0;
+        for (; i < count; ++i) {
+            dst[i] = static_cast<HalfType>(src[i]);
+            didOverflow |= (std::bit_cast<uint16_t>(dst[i]) & 0x7C00) == 0x7C00;
+        }
+        return didOverflow;
+    }
+#endif
+
+    inline void widenHalf(const HalfType* src, float* dst, size_t count)
+    {
+#if defined(HAS_F16C_KERNELS)
+        if (hasF16C())
+            return widenHalfF16C(src, dst, count);
+#endif
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<float>(src[i]);
+    }
+
+    inline bool narrowHalf(const float* src, HalfType* dst, size_t count)
+    {
+#if defined(HAS_F16C_KERNELS)
+        if (hasF16C())
+            return narrowHalfF16C(src, dst, count);
+#endif
+        bool didOverflow = false;
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = static_cast<HalfType>(src[i]);
+            didOverflow |= (std::bit_cast<uint16_t>(dst[i]) & 0x7C00) == 0x7C00;
+        }
+        return didOverflow;
+    }
+#endif
+
+#if defined(HAS_BFLOAT16_DECIMAL)
+    // bfloat16 is the upper half of a float, widening is a shift.
+    inline void widenBFloat16(const BFloat16Type* src, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = std::bit_cast<float>(static_cast<uint32_t>(std::bit_cast<uint16_t>(src[i])) << 16);
+    }
+
+    // Rounds to nearest even on the float bits, the inputs are finite so the add can't carry out.
+    inline bool narrowBFloat16(const float* src, BFloat16Type* dst, size_t count)
+    {
+        bool didOverflow = false;
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t bits = std::bit_cast<uint32_t>(src[i]);
+            const uint16_t rounded = static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16);
+            didOverflow |= (rounded & 0x7F80) == 0x7F80;
+            dst[i] = std::bit_cast<BFloat16Type>(rounded);
+        }
+        return didOverflow;
+    }
+#endif
+}
+
+export namespace NH_NAMESPACE
+{
+#if defined(HAS_HALF_DECIMAL)
+    // Widening can't fail, narrowing asserts once if any value overflows to infinity.
+    inline void widen(std::span<const SafeHalf> src, std::span<SafeFloat> dst)
+    {
+        Assert(dst.size() >= src.size());
+        widenHalf(rawData(src), rawData(dst), src.size());
+    }
+
+    inline void narrow(std::span<const SafeFloat> src, std::span<SafeHalf> dst)
+    {
+        Assert(dst.size() >= src.size());
+        const bool didOverflow = narrowHalf(rawData(src), rawData(dst), src.size());
+        if (didOverflow)
+            clearOverflow(rawData(dst), src.size(), 0x7C00);
+        Assert(!didOverflow);
+    }
+#endif
+
+#if defined(HAS_BFLOAT16_DECIMAL)
+    inline void widen(std::span<const SafeBFloat16> src, std::span<SafeFloat> dst)
+    {
+        Assert(dst.size() >= src.size());
+        widenBFloat16(rawData(src), rawData(dst), src.size());
+    }
+
+    inline void narrow(std::span<const SafeFloat> src, std::span<SafeBFloat16> dst)
+    {
+        Assert(dst.size() >= src.size());
+        const bool didOverflow = narrowBFloat16(rawData(src), rawData(dst), src.size());
+        if (didOverflow)
+            clearOverflow(rawData(dst), src.size(), 0x7F80);
+        Assert(!didOverflow);
+    }
+#endif
 }
 
 export namespace std {
@@ -0,0 +1,181 @@
+module;
+
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+export module nhtypes:expressions;
+
+import :common;
+import :integers;
+
+#if defined(__SIZEOF_INT128__)
+
+namespace NH_NAMESPACE {
+
+    enum class LazyOperation { Add, Subtract, Multiply, Negate };
+
+    // Range of the values an expression can produce, invalid if it doesn't fit into 128 bits.
+    struct LazyBounds {
+        int128_t min;
+        int128_t max;
+        bool isValid;
+
+        constexpr bool fitsInto64() const {
+            return min >= std::numeric_limits<int64_t>::min() && max <= std::numeric_limits<int64_t>::max();
+        }
+    };
+
+    constexpr inline LazyBounds combineBounds(LazyOperation operation, LazyBounds lhs, LazyBounds rhs) {
+        LazyBounds result { 0, 0, lhs.isValid && rhs.isValid };
+        switch (operation) {
+        case LazyOperation::Add:
+            result.isValid &= !__builtin_add_overflow(lhs.min, rhs.min, &result.min);
+            result.isValid &= !__builtin_add_overflow(lhs.max, rhs.max, &result.max);
+            break;
+        case LazyOperation::Subtract:
+            result.isValid &= !__builtin_sub_overflow(lhs.min, rhs.max, &result.min);
+            result.isValid &= !__builtin_sub_overflow(lhs.max, rhs.min, &result.max);
+            break;
+        case LazyOperation::Multiply: {
+            const int128_t lhsBounds[] = { lhs.min, lhs.max };
+            const int128_t rhsBounds[] = { rhs.min, rhs.max };
+            bool isFirst = true;
+            for (const int128_t first : lhsBounds) {
+                for (const int128_t second : rhsBounds) {
+                    int128_t product = 0;
+                    result.isValid &= !__builtin_mul_overflow(first, second, &product);
+                    result.min = isFirst || product < result.min ? product : result.min;
+                    result.max = isFirst || product > result.max ? product : result.max;
+                    isFirst = false;
+                }
+            }
+            break;
+        }
+        case LazyOperation::Negate:
+            result.isValid &= !__builtin_sub_overflow(int128_t(0), lhs.max, &result.min);
+            result.isValid &= !__builtin_sub_overflow(int128_t(0), lhs.min, &result.max);
+            break;
+        }
+        return result;
+    }
+
+    template <typename Expression>
+    concept isLazyExpression = requires {
+        { Expression::Bounds } -> std::convertible_to<LazyBounds>;
+        { Expression::FitsInto64 } -> std::convertible_to<bool>;
+    };
+
+    // Converting an expression to a SafeInt evaluates it in int64 when every node provably fits,
+    // in int128 otherwise, and performs the only range check.
+    template <typename Derived>
+    struct LazyExpressionBase {
+        template <typename IntType>
+        constexpr operator SafeInt<IntType>() const {
+            static_assert(Derived::Bounds.isValid, "Expression can overflow 128 bits, split it into smaller ones");
+
+            using Wide = std::conditional_t<Derived::FitsInto64, int64_t, int128_t>;
+            const Wide result = static_cast<Derived const &>(*this).template evaluate<Wide>();
+            // Compared in int128, uint64 Max doesn't fit into int64.
+            Assert(static_cast<int128_t>(result) >= static_cast<int128_t>(SafeInt<IntType>::Min) &&
+                   static_cast<int128_t>(result) <= static_cast<int128_t>(SafeInt<IntType>::Max));
+            return static_cast<IntType>(result);
+        }
+    };
+
+    template <typename IntType>
+    struct LazyLeaf : LazyExpressionBase<LazyLeaf<IntType>> {
+        static constexpr LazyBounds Bounds {
+            std::numeric_limits<IntType>::min(), std::numeric_limits<IntType>::max(), true
+        };
+        static constexpr bool FitsInto64 = Bounds.fitsInto64();
+
+        IntType m_value;
+
+        template <typename Wide>
+        constexpr Wide evaluate() const { return static_cast<Wide>(m_value); }
+    };
+
+    // Right hand side of unary nodes.
+    struct LazyNone {
+        static constexpr LazyBounds Bounds { 0, 0, true };
+        static constexpr bool FitsInto64 = true;
+    };
+
+    template <LazyOperation Operation, typename Lhs, typename Rhs = LazyNone>
+    struct LazyNode : LazyExpressionBase<LazyNode<Operation, Lhs, Rhs>> {
+        static constexpr LazyBounds Bounds = combineBounds(Operation, Lhs::Bounds, Rhs::Bounds);
+        static constexpr bool FitsInto64 = Lhs::FitsInto64 && Rhs::FitsInto64 && Bounds.fitsInto64();
+
+        Lhs m_lhs;
+        [[no_unique_address]] Rhs m_rhs;
+
+        template <typename Wide>
+        constexpr Wide evaluate() const {
+            if constexpr (Operation == LazyOperation::Add)
+                return m_lhs.template evaluate<Wide>() + m_rhs.template evaluate<Wide>();
+            else if constexpr (Operation == LazyOperation::Subtract)
+                return m_lhs.template evaluate<Wide>() - m_rhs.template evaluate<Wide>();
+            else if constexpr (Operation == LazyOperation::Multiply)
+                return m_lhs.template evaluate<Wide>() * m_rhs.template evaluate<Wide>();
+            else
+                return -m_lhs.template evaluate<Wide>();
+        }
+    };
+
+    template <typename IntType>
+    constexpr inline LazyLeaf<IntType> toLazy(SafeInt<IntType> value) { return { {}, +value }; }
+
+    template <typename IntType>
+    constexpr inline LazyLeaf<IntType> toLazy(FastInt<IntType> value) { return { {}, +value }; }
+
+    template <std::integral IntType>
+    constexpr inline LazyLeaf<IntType> toLazy(IntType value) { return { {}, value }; }
+
+    template <isLazyExpression Expression>
+    constexpr inline Expression toLazy(Expression expression) { return expression; }
+
+    template <typename T>
+    concept isLazyOperand = requires(T value) { toLazy(value); };
+
+    // At least one side must already be lazy, plain SafeInt arithmetic stays eager.
+    template <typename Lhs, typename Rhs>
+    concept isLazyOperation = isLazyOperand<Lhs> && isLazyOperand<Rhs> && (isLazyExpression<Lhs> || isLazyExpression<Rhs>);
+
+    template <LazyOperation Operation, typename Lhs, typename Rhs>
+    constexpr inline auto makeLazyNode(Lhs lhs, Rhs rhs) {
+        using LhsNode = decltype(toLazy(lhs));
+        using RhsNode = decltype(toLazy(rhs));
+        return LazyNode<Operation, LhsNode, RhsNode> { {}, toLazy(lhs), toLazy(rhs) };
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    // Opt-in lazy evaluation: lazy(a) * b + lazy(c) * d - e builds the expression at compile time
+    // and checks the result once when it is assigned to a SafeInt, instead of once per operator.
+    template <typename IntType>
+    constexpr inline auto lazy(SafeInt<IntType> value) { return toLazy(value); }
+
+    template <typename IntType>
+    constexpr inline auto lazy(FastInt<IntType> value) { return toLazy(value); }
+
+    template <typename Lhs, typename Rhs>
+    requires isLazyOperation<Lhs, Rhs>
+    constexpr inline auto operator+(Lhs lhs, Rhs rhs) { return makeLazyNode<LazyOperation::Add>(lhs, rhs); }
+
+    template <typename Lhs, typename Rhs>
+    requires isLazyOperation<Lhs, Rhs>
+    constexpr inline auto operator-(Lhs lhs, Rhs rhs) { return makeLazyNode<LazyOperation::Subtract>(lhs, rhs); }
+
+    template <typename Lhs, typename Rhs>
+    requires isLazyOperation<Lhs, Rhs>
+    constexpr inline auto operator*(Lhs lhs, Rhs rhs) { return makeLazyNode<LazyOperation::Multiply>(lhs, rhs); }
+
+    template <isLazyExpression Expression>
+    constexpr inline auto operator-(Expression expression) {
+        return LazyNode<LazyOperation::Negate, Expression> { {}, expression, {} };
+    }
+}
+
+#endif
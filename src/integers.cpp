@@ -7,10 +7,17 @@ export module nhtypes:integers;
 
 import :common;
 import :boolean;
+import :profiling;
 
 #define ENABLE_IF_UNSIGNED(Type) requires(std::is_unsigned_v<Type>)
 #define ENABLE_IF_SIGNED(Type) requires(std::is_signed_v<Type>)
 
+#if ENABLE_OVERFLOW_PROFILING
+#    define PROFILE_OPERATION(operand, result) profileOperation(operand, result)
+#else
+#    define PROFILE_OPERATION(operand, result)
+#endif
+
 namespace NH_NAMESPACE {
 
 #define FRIEND_COMPARISON_OPERATORS(Type)                                         \
@@ -28,12 +35,12 @@ namespace NH_NAMESPACE {
     friend constexpr Type operator<<(Type lhs, Type rhs) ENABLE_IF_UNSIGNED(CType) { return lhs <<= rhs; } \
     friend constexpr Type operator>>(Type lhs, Type rhs) ENABLE_IF_UNSIGNED(CType) { return lhs >>= rhs; }  
 
-#define FRIEND_ARITHMETIC_OPERATORS(Type)                                      \
-    friend constexpr Type operator+(Type lhs, Type rhs) { return lhs += rhs; } \
-    friend constexpr Type operator-(Type lhs, Type rhs) { return lhs -= rhs; } \
-    friend constexpr Type operator/(Type lhs, Type rhs) { return lhs /= rhs; } \
-    friend constexpr Type operator*(Type lhs, Type rhs) { return lhs *= rhs; } \
-    friend constexpr Type operator%(Type lhs, Type rhs) { return lhs %= rhs; }
+#define FRIEND_ARITHMETIC_OPERATORS(Type, OperandType)                                \
+    friend constexpr Type operator+(Type lhs, OperandType rhs) { return lhs += rhs; } \
+    friend constexpr Type operator-(Type lhs, OperandType rhs) { return lhs -= rhs; } \
+    friend constexpr Type operator/(Type lhs, OperandType rhs) { return lhs /= rhs; } \
+    friend constexpr Type operator*(Type lhs, OperandType rhs) { return lhs *= rhs; } \
+    friend constexpr Type operator%(Type lhs, OperandType rhs) { return lhs %= rhs; }
 
     template <typename IntType>
     struct IntBase {
@@ -55,6 +62,12 @@ namespace NH_NAMESPACE {
         typedef IntBase<IntType> Base;
         using Base::m_value;
         using CType = IntType;
+
+#if ENABLE_OVERFLOW_PROFILING
+        using Operand = ProfiledOperand<SafeInt>;
+#else
+        using Operand = SafeInt;
+#endif
     
     public:      
         constexpr inline SafeInt(int64_t value = 0) ENABLE_IF_SIGNED(IntType) : Base(value) {
@@ -100,64 +113,71 @@ namespace NH_NAMESPACE {
             return -m_value; 
         }
 
-        constexpr SafeInt & operator+=(SafeInt rhs) ENABLE_IF_UNSIGNED(IntType) { 
+        constexpr SafeInt & operator+=(Operand rhs) ENABLE_IF_UNSIGNED(IntType) { 
             const IntType result = m_value + rhs.m_value;
             Assert(result >= m_value);        
             m_value = result; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this; 
         }
 
-        constexpr SafeInt & operator+=(SafeInt rhs) ENABLE_IF_SIGNED(IntType) { 
+        constexpr SafeInt & operator+=(Operand rhs) ENABLE_IF_SIGNED(IntType) { 
             const bool didOverflow {
                 (rhs.m_value > 0 && m_value > Max - rhs.m_value) ||
                 (rhs.m_value < 0 && m_value < Min - rhs.m_value)
             };
             Assert(!didOverflow);
             m_value += rhs.m_value; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this; 
         }
 
-        constexpr SafeInt & operator-=(SafeInt rhs) ENABLE_IF_UNSIGNED(IntType) { 
+        constexpr SafeInt & operator-=(Operand rhs) ENABLE_IF_UNSIGNED(IntType) { 
             const IntType result = m_value - rhs.m_value; 
             Assert(result <= m_value); // result > m_value -> overflow
             m_value = result; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this;
         }
 
-        constexpr SafeInt & operator-=(SafeInt rhs) ENABLE_IF_SIGNED(IntType) { 
+        constexpr SafeInt & operator-=(Operand rhs) ENABLE_IF_SIGNED(IntType) { 
             const bool didOverflow {
                 (rhs.m_value < 0 && m_value > Max + rhs.m_value) ||
                 (rhs.m_value > 0 && m_value < Min + rhs.m_value)
             };
             Assert(!didOverflow);
             m_value -= rhs.m_value;  
+            PROFILE_OPERATION(rhs, m_value);
             return *this;
         }
 
-        constexpr SafeInt & operator/=(SafeInt rhs) ENABLE_IF_UNSIGNED(IntType) {
+        constexpr SafeInt & operator/=(Operand rhs) ENABLE_IF_UNSIGNED(IntType) {
             Assert(rhs.m_value != 0);
             m_value = m_value / rhs.m_value; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this;
         }
 
-        constexpr SafeInt & operator/=(SafeInt rhs) ENABLE_IF_SIGNED(IntType) {
+        constexpr SafeInt & operator/=(Operand rhs) ENABLE_IF_SIGNED(IntType) {
             const bool didOverflow {
                 rhs.m_value == 0 || (rhs.m_value == -1 && m_value == Min)
             };
             Assert(!didOverflow);
             m_value *= rhs.m_value;
+            PROFILE_OPERATION(rhs, m_value);
             return *this; 
         }
 
-        constexpr SafeInt & operator*=(SafeInt rhs) ENABLE_IF_UNSIGNED(IntType) {
+        constexpr SafeInt & operator*=(Operand rhs) ENABLE_IF_UNSIGNED(IntType) {
             const IntType result = m_value * rhs.m_value;
             const bool didOverflow = result < m_value && rhs.m_value != 0;
             Assert(!didOverflow);
             m_value = result; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this;
         }
 
-        constexpr SafeInt & operator*=(SafeInt rhs) ENABLE_IF_SIGNED(IntType) {
+        constexpr SafeInt & operator*=(Operand rhs) ENABLE_IF_SIGNED(IntType) {
             const bool didOverflow {
                 (m_value == -1 && rhs.m_value == Min) ||
                 (rhs.m_value == -1 && m_value == Min) ||
@@ -166,6 +186,7 @@ namespace NH_NAMESPACE {
             };
             Assert(!didOverflow);
             m_value *= rhs.m_value; 
+            PROFILE_OPERATION(rhs, m_value);
             return *this;
         }
 
@@ -189,7 +210,7 @@ namespace NH_NAMESPACE {
         }
 
         FRIEND_COMPARISON_OPERATORS(SafeInt)
-        FRIEND_ARITHMETIC_OPERATORS(SafeInt)
+        FRIEND_ARITHMETIC_OPERATORS(SafeInt, Operand)
         FRIEND_BITWISE_OPERATORS(SafeInt, IntType)
 
         public:
@@ -246,7 +267,7 @@ namespace NH_NAMESPACE {
         constexpr FastInt & operator>>=(FastInt rhs) ENABLE_IF_UNSIGNED(IntType) { m_value >>= rhs.m_value; return *this; }
 
         FRIEND_COMPARISON_OPERATORS(FastInt)
-        FRIEND_ARITHMETIC_OPERATORS(FastInt)
+        FRIEND_ARITHMETIC_OPERATORS(FastInt, FastInt)
         FRIEND_BITWISE_OPERATORS(FastInt, IntType)
 
         public:
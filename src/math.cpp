@@ -0,0 +1,330 @@
+module;
+
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+export module nhtypes:math;
+
+import :common;
+import :integers;
+import :decimals;
+
+namespace NH_NAMESPACE {
+
+    template <typename IntType>
+    constexpr inline bool multiplyOverflows(IntType lhs, IntType rhs, IntType & result) {
+#if __has_builtin(__builtin_mul_overflow)
+        return __builtin_mul_overflow(lhs, rhs, &result);
+#else
+        using Wide = WideIntType<IntType>;
+        const Wide product = static_cast<Wide>(lhs) * rhs;
+        result = static_cast<IntType>(product);
+        return product < static_cast<Wide>(SafeInt<IntType>::Min) || product > static_cast<Wide>(SafeInt<IntType>::Max);
+#endif
+    }
+
+    template <typename IntType>
+    constexpr inline std::make_unsigned_t<IntType> magnitude(IntType value) {
+        using Unsigned = std::make_unsigned_t<IntType>;
+        return value < 0 ? static_cast<Unsigned>(Unsigned(0) - static_cast<Unsigned>(value)) : static_cast<Unsigned>(value);
+    }
+
+    // Exponentiation by squaring, stops as soon as a square or product overflows.
+    template <typename IntType>
+    constexpr inline bool powOverflows(IntType base, uint32_t exponent, IntType & result) {
+        IntType value = 1;
+        while (true) {
+            if ((exponent & 1) && multiplyOverflows(value, base, value))
+                return true;
+            exponent >>= 1;
+            if (exponent == 0)
+                break;
+            if (multiplyOverflows(base, base, base))
+                return true;
+        }
+        result = value;
+        return false;
+    }
+
+    // Newton iteration starting above the root, converges from above in a few steps.
+    template <typename Unsigned>
+    constexpr inline Unsigned unsignedSqrt(Unsigned value) {
+        if (value < 2)
+            return value;
+
+        Unsigned root = static_cast<Unsigned>(Unsigned(1) << ((std::bit_width(value) + 1) / 2));
+        while (true) {
+            const Unsigned next = static_cast<Unsigned>((root + value / root) / 2);
+            if (next >= root)
+                return root;
+            root = next;
+        }
+    }
+
+    // Binary gcd, strips common factors of two with a single count of trailing zeros.
+    template <typename Unsigned>
+    constexpr inline Unsigned unsignedGcd(Unsigned lhs, Unsigned rhs) {
+        if (lhs == 0) return rhs;
+        if (rhs == 0) return lhs;
+
+        const int shift = std::countr_zero(static_cast<Unsigned>(lhs | rhs));
+        lhs >>= std::countr_zero(lhs);
+        do {
+            rhs >>= std::countr_zero(rhs);
+            if (lhs > rhs)
+                std::swap(lhs, rhs);
+            rhs -= lhs;
+        } while (rhs != 0);
+
+        return static_cast<Unsigned>(lhs << shift);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    // lhs + (rhs - lhs) * numerator / denominator, truncating the step towards lhs like std::midpoint.
+    // The product needs at most 65 + 32 bits, so int128 holds every intermediate value.
+    template <typename IntType>
+    constexpr inline bool lerpOverflows(IntType lhs, IntType rhs, uint32_t numerator, uint32_t denominator, IntType & result) {
+        const int128_t step = (static_cast<int128_t>(rhs) - lhs) * numerator / denominator;
+        const int128_t value = lhs + step;
+        result = static_cast<IntType>(value);
+        return value < static_cast<int128_t>(SafeInt<IntType>::Min) || value > static_cast<int128_t>(SafeInt<IntType>::Max);
+    }
+#endif
+
+    // A single rounding, maps to one instruction when the target has FMA (FP_FAST_FMA).
+    template <typename FloatingPointType>
+    inline FloatingPointType fusedMultiplyAdd(FloatingPointType lhs, FloatingPointType rhs, FloatingPointType addend) {
+        return static_cast<FloatingPointType>(std::fma(lhs, rhs, addend));
+    }
+
+    // Infinity and NaN are absorbing under fma with finite operands (inf * 0 is NaN, inf + c is inf),
+    // so checking the final result covers every intermediate step.
+    template <typename FloatingPointType>
+    inline FloatingPointType hornerUnchecked(FloatingPointType x, std::span<const FloatingPointType> coefficients) {
+        FloatingPointType result = 0;
+        for (size_t i = coefficients.size(); i-- > 0;)
+            result = fusedMultiplyAdd(result, x, coefficients[i]);
+        return result;
+    }
+
+    template <typename FloatingPointType>
+    inline FloatingPointType dotUnchecked(std::span<const FloatingPointType> lhs, std::span<const FloatingPointType> rhs) {
+        FloatingPointType result = 0;
+        for (size_t i = 0; i < lhs.size(); ++i)
+            result = fusedMultiplyAdd(lhs[i], rhs[i], result);
+        return result;
+    }
+
+    // SafeDecimal's constructor is noexcept, assert before constructing so the assertion can propagate.
+    template <typename FloatingPointType>
+    inline SafeDecimal<FloatingPointType> checkedDecimal(FloatingPointType value) {
+        Assert(!isInfinityOrNan(value));
+        return value;
+    }
+
+    // Decimal types are plain wrappers (see type_traits), so their spans can be viewed as spans of CType.
+    template <typename Decimal>
+    inline std::span<const typename Decimal::CType> rawSpan(std::span<const Decimal> values) {
+        return { reinterpret_cast<const typename Decimal::CType*>(values.data()), values.size() };
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> abs(SafeInt<IntType> value) {
+        if constexpr (std::is_signed_v<IntType>) {
+            Assert(+value != SafeInt<IntType>::Min);
+            return +value < 0 ? -value : value;
+        } else {
+            return value;
+        }
+    }
+
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> pow(SafeInt<IntType> base, uint32_t exponent) {
+        IntType result = 0;
+        Assert(!powOverflows(+base, exponent, result));
+        return result;
+    }
+
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> gcd(SafeInt<IntType> lhs, SafeInt<IntType> rhs) {
+        const auto result = unsignedGcd(magnitude(+lhs), magnitude(+rhs));
+        Assert(result <= static_cast<std::make_unsigned_t<IntType>>(SafeInt<IntType>::Max)); // gcd(Min, 0)
+        return static_cast<IntType>(result);
+    }
+
+    // Floor of the square root, asserts on negative values.
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> isqrt(SafeInt<IntType> value) {
+        Assert(+value >= 0);
+        return static_cast<IntType>(unsignedSqrt(magnitude(+value)));
+    }
+
+    // Never overflows, rounds towards lhs like std::midpoint.
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> midpoint(SafeInt<IntType> lhs, SafeInt<IntType> rhs) {
+        return std::midpoint(+lhs, +rhs);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    // Interpolates by numerator / denominator with midpoint's rounding, so lerp(a, b, 1, 2) == midpoint(a, b).
+    // Fractions above one extrapolate and assert if the result leaves the range.
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> lerp(SafeInt<IntType> lhs, SafeInt<IntType> rhs, uint32_t numerator, uint32_t denominator) {
+        Assert(denominator != 0);
+        IntType result = 0;
+        Assert(!lerpOverflows(+lhs, +rhs, numerator, denominator, result));
+        return result;
+    }
+#endif
+
+    // Unlike operator<<=, asserts that no set bits (or the sign) are shifted out.
+    template <typename IntType>
+    constexpr inline SafeInt<IntType> shiftLeft(SafeInt<IntType> value, uint32_t count) {
+        using Unsigned = std::make_unsigned_t<IntType>;
+        Assert(count < sizeof(IntType) * 8);
+        const IntType result = static_cast<IntType>(static_cast<Unsigned>(+value) << count);
+        Assert(static_cast<IntType>(result >> count) == +value);
+        return result;
+    }
+
+    // Span variants, these collect the overflow state of all elements and assert once per call.
+
+    template <typename IntType>
+    inline void abs(std::span<SafeInt<IntType>> values) {
+        if constexpr (std::is_signed_v<IntType>) {
+            bool didOverflow = false;
+            for (SafeInt<IntType> & value : values) {
+                didOverflow |= +value == SafeInt<IntType>::Min;
+                value = static_cast<IntType>(magnitude(+value));
+            }
+            Assert(!didOverflow);
+        }
+    }
+
+    template <typename IntType>
+    inline void pow(std::span<SafeInt<IntType>> values, uint32_t exponent) {
+        bool didOverflow = false;
+        for (SafeInt<IntType> & value : values) {
+            IntType result = 0;
+            didOverflow |= powOverflows(+value, exponent, result);
+            value = result;
+        }
+        Assert(!didOverflow);
+    }
+
+    template <typename IntType>
+    inline void isqrt(std::span<SafeInt<IntType>> values) {
+        bool isNegative = false;
+        for (SafeInt<IntType> & value : values) {
+            isNegative |= +value < 0;
+            value = static_cast<IntType>(unsignedSqrt(magnitude(+value)));
+        }
+        Assert(!isNegative);
+    }
+
+    // gcd of all values, stops early once it reaches one.
+    template <typename IntType>
+    inline SafeInt<IntType> gcd(std::span<const SafeInt<IntType>> values) {
+        std::make_unsigned_t<IntType> result = 0;
+        for (const SafeInt<IntType> value : values) {
+            result = unsignedGcd(result, magnitude(+value));
+            if (result == 1)
+                break;
+        }
+        Assert(result <= static_cast<std::make_unsigned_t<IntType>>(SafeInt<IntType>::Max));
+        return static_cast<IntType>(result);
+    }
+
+    template <typename IntType>
+    inline void midpoint(std::span<const SafeInt<IntType>> lhs, std::span<const SafeInt<IntType>> rhs, std::span<SafeInt<IntType>> result) {
+        Assert(lhs.size() == rhs.size() && result.size() >= lhs.size());
+        for (size_t i = 0; i < lhs.size(); ++i)
+            result[i] = std::midpoint(+lhs[i], +rhs[i]);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    template <typename IntType>
+    inline void lerp(std::span<const SafeInt<IntType>> lhs, std::span<const SafeInt<IntType>> rhs, uint32_t numerator, uint32_t denominator, std::span<SafeInt<IntType>> result) {
+        Assert(lhs.size() == rhs.size() && result.size() >= lhs.size() && denominator != 0);
+        bool didOverflow = false;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            IntType value = 0;
+            didOverflow |= lerpOverflows(+lhs[i], +rhs[i], numerator, denominator, value);
+            result[i] = value;
+        }
+        Assert(!didOverflow);
+    }
+#endif
+
+    template <typename IntType>
+    inline void shiftLeft(std::span<SafeInt<IntType>> values, uint32_t count) {
+        using Unsigned = std::make_unsigned_t<IntType>;
+        Assert(count < sizeof(IntType) * 8);
+        bool didOverflow = false;
+        for (SafeInt<IntType> & value : values) {
+            const IntType result = static_cast<IntType>(static_cast<Unsigned>(+value) << count);
+            didOverflow |= static_cast<IntType>(result >> count) != +value;
+            value = result;
+        }
+        Assert(!didOverflow);
+    }
+
+    // Decimal fused multiply-add, lhs * rhs + addend with one rounding and one finiteness check.
+    // The product itself may exceed Max as long as the final result is finite.
+
+    template <typename FloatingPointType>
+    inline SafeDecimal<FloatingPointType> fma(SafeDecimal<FloatingPointType> lhs, SafeDecimal<FloatingPointType> rhs, SafeDecimal<FloatingPointType> addend) {
+        return checkedDecimal(fusedMultiplyAdd(+lhs, +rhs, +addend));
+    }
+
+    template <typename FloatingPointType>
+    inline FastDecimal<FloatingPointType> fma(FastDecimal<FloatingPointType> lhs, FastDecimal<FloatingPointType> rhs, FastDecimal<FloatingPointType> addend) {
+        return fusedMultiplyAdd(+lhs, +rhs, +addend);
+    }
+
+    // Horner evaluation of coefficients[0] + coefficients[1] * x + ..., asserts once on the result.
+    template <typename FloatingPointType>
+    inline SafeDecimal<FloatingPointType> horner(SafeDecimal<FloatingPointType> x, std::span<const SafeDecimal<FloatingPointType>> coefficients) {
+        return checkedDecimal(hornerUnchecked(+x, rawSpan(coefficients)));
+    }
+
+    template <typename FloatingPointType>
+    inline FastDecimal<FloatingPointType> horner(FastDecimal<FloatingPointType> x, std::span<const FastDecimal<FloatingPointType>> coefficients) {
+        return hornerUnchecked(+x, rawSpan(coefficients));
+    }
+
+    // Evaluates the polynomial at every x, asserts once per call.
+    template <typename FloatingPointType>
+    inline void horner(std::span<const SafeDecimal<FloatingPointType>> x, std::span<const SafeDecimal<FloatingPointType>> coefficients, std::span<SafeDecimal<FloatingPointType>> result) {
+        Assert(result.size() >= x.size());
+        const auto rawCoefficients = rawSpan(coefficients);
+        bool isNotFinite = false;
+        for (size_t i = 0; i < x.size(); ++i) {
+            const FloatingPointType value = hornerUnchecked(+x[i], rawCoefficients);
+            isNotFinite |= isInfinityOrNan(value);
+            // Keep the element valid even if the call asserts below.
+            result[i] = isInfinityOrNan(value) ? FloatingPointType(0) : value;
+        }
+        Assert(!isNotFinite);
+    }
+
+    // Fused dot product, a single rounding per element and one finiteness check for the whole span.
+    template <typename FloatingPointType>
+    inline SafeDecimal<FloatingPointType> dot(std::span<const SafeDecimal<FloatingPointType>> lhs, std::span<const SafeDecimal<FloatingPointType>> rhs) {
+        Assert(lhs.size() == rhs.size());
+        return checkedDecimal(dotUnchecked(rawSpan(lhs), rawSpan(rhs)));
+    }
+
+    template <typename FloatingPointType>
+    inline FastDecimal<FloatingPointType> dot(std::span<const FastDecimal<FloatingPointType>> lhs, std::span<const FastDecimal<FloatingPointType>> rhs) {
+        Assert(lhs.size() == rhs.size());
+        return dotUnchecked(rawSpan(lhs), rawSpan(rhs));
+    }
+}
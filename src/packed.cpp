@@ -0,0 +1,235 @@
+module;
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+export module nhtypes:packed;
+
+import :common;
+import :integers;
+
+#define ENABLE_IF_UNSIGNED(Type) requires(std::is_unsigned_v<Type>)
+#define ENABLE_IF_SIGNED(Type) requires(std::is_signed_v<Type>)
+
+#define FRIEND_COMPARISON_OPERATORS(Type)                                         \
+    friend constexpr bool operator==(Type lhs, Type rhs) { return +lhs == +rhs; } \
+    friend constexpr bool operator!=(Type lhs, Type rhs) { return +lhs != +rhs; } \
+    friend constexpr bool operator<(Type lhs, Type rhs) { return +lhs < +rhs; }   \
+    friend constexpr bool operator>(Type lhs, Type rhs) { return +lhs > +rhs; }   \
+    friend constexpr bool operator>=(Type lhs, Type rhs) { return +lhs >= +rhs; } \
+    friend constexpr bool operator<=(Type lhs, Type rhs) { return +lhs <= +rhs; }
+
+#define FRIEND_ARITHMETIC_OPERATORS(Type)                                      \
+    friend constexpr Type operator+(Type lhs, Type rhs) { return lhs += rhs; } \
+    friend constexpr Type operator-(Type lhs, Type rhs) { return lhs -= rhs; } \
+    friend constexpr Type operator/(Type lhs, Type rhs) { return lhs /= rhs; } \
+    friend constexpr Type operator*(Type lhs, Type rhs) { return lhs *= rhs; } \
+    friend constexpr Type operator%(Type lhs, Type rhs) { return lhs %= rhs; }
+
+namespace NH_NAMESPACE {
+
+    template <uint32_t Bits, bool IsSigned>
+    struct BitIntStorage {
+        using Unsigned = std::conditional_t<(Bits <= 8), uint8_t,
+                         std::conditional_t<(Bits <= 16), uint16_t,
+                         std::conditional_t<(Bits <= 32), uint32_t, uint64_t>>>;
+        using type = std::conditional_t<IsSigned, std::make_signed_t<Unsigned>, Unsigned>;
+    };
+
+    constexpr inline uint64_t lowBitMask(uint32_t bits) {
+        return bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    // Integer checked against the range of exactly Bits bits, stored in the smallest fitting type.
+    template <uint32_t Bits, bool IsSigned>
+    struct SafeBitInt
+    {
+        static_assert(Bits >= 1 && Bits <= 64, "SafeBitInt supports 1 to 64 bits");
+
+        using CType = typename BitIntStorage<Bits, IsSigned>::type;
+
+        static constexpr uint32_t Width = Bits;
+        static constexpr CType Max = static_cast<CType>(lowBitMask(IsSigned ? Bits - 1 : Bits));
+        static constexpr CType Min = IsSigned ? static_cast<CType>(-Max - 1) : CType(0);
+
+        constexpr SafeBitInt(int64_t value = 0) ENABLE_IF_SIGNED(CType) : m_value(static_cast<CType>(value)) {
+            Assert(value >= Min && value <= Max);
+        }
+
+        constexpr SafeBitInt(uint64_t value = 0) ENABLE_IF_UNSIGNED(CType) : m_value(static_cast<CType>(value)) {
+            Assert(value <= Max);
+        }
+
+        explicit constexpr SafeBitInt(SafeInt<CType> value) : SafeBitInt(+value) {}
+
+        constexpr CType operator+() const { return m_value; }
+        constexpr operator SafeInt<CType>() const { return m_value; }
+
+        constexpr SafeBitInt & operator+=(SafeBitInt rhs) { return assign(Wide(m_value) + rhs.m_value); }
+        constexpr SafeBitInt & operator-=(SafeBitInt rhs) { return assign(Wide(m_value) - rhs.m_value); }
+        constexpr SafeBitInt & operator*=(SafeBitInt rhs) { return assign(Wide(m_value) * rhs.m_value); }
+
+        constexpr SafeBitInt & operator/=(SafeBitInt rhs) {
+            Assert(rhs.m_value != 0);
+            return assign(Wide(m_value) / rhs.m_value);
+        }
+
+        constexpr SafeBitInt & operator%=(SafeBitInt rhs) {
+            Assert(rhs.m_value != 0);
+            return assign(Wide(m_value) % rhs.m_value);
+        }
+
+        constexpr SafeBitInt & operator++() { return assign(Wide(m_value) + 1); }
+        constexpr SafeBitInt & operator--() { return assign(Wide(m_value) - 1); }
+        constexpr SafeBitInt operator++(auto) { SafeBitInt previous = *this; ++*this; return previous; }
+        constexpr SafeBitInt operator--(auto) { SafeBitInt previous = *this; --*this; return previous; }
+
+        FRIEND_COMPARISON_OPERATORS(SafeBitInt)
+        FRIEND_ARITHMETIC_OPERATORS(SafeBitInt)
+
+    private:
+        using Wide = WideIntType<CType>;
+
+        // Wide keeps the signedness of CType and holds any product, unsigned results that wrap
+        // below zero end up above Max.
+        constexpr SafeBitInt & assign(Wide result) {
+            Assert(result >= static_cast<Wide>(Min) && result <= static_cast<Wide>(Max));
+            m_value = static_cast<CType>(result);
+            return *this;
+        }
+
+        CType m_value;
+    };
+
+    template <uint32_t Bits>
+    using SafeUInt = SafeBitInt<Bits, false>;
+
+    template <uint32_t Bits>
+    using SafeSInt = SafeBitInt<Bits, true>;
+
+    template <typename T>
+    struct PackedArray;
+
+    // Array of SafeBitInt values stored back to back at Bits bits each. Values may straddle two
+    // words; a trailing padding word lets reads always load two words without branching.
+    template <uint32_t Bits, bool IsSigned>
+    struct PackedArray<SafeBitInt<Bits, IsSigned>>
+    {
+        using ValueType = SafeBitInt<Bits, IsSigned>;
+        using CType = typename ValueType::CType;
+
+        static constexpr uint64_t Mask = lowBitMask(Bits);
+
+        PackedArray(size_t count = 0) { resize(count); }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // Shrinking clears the dropped bits, so growing again yields zeros.
+        void resize(size_t count) {
+            if (count < m_size) {
+                const size_t bit = count * Bits;
+                m_words[bit / 64] &= lowBitMask(bit % 64);
+                std::fill(m_words.begin() + bit / 64 + 1, m_words.end(), 0);
+            }
+            m_words.resize((count * Bits + 63) / 64 + 1, 0);
+            m_size = count;
+        }
+
+        void push_back(ValueType value) {
+            resize(m_size + 1);
+            store(m_size - 1, static_cast<uint64_t>(+value));
+        }
+
+        ValueType operator[](size_t index) const {
+            Assert(index < m_size);
+            return load(index);
+        }
+
+        void set(size_t index, ValueType value) {
+            Assert(index < m_size);
+            store(index, static_cast<uint64_t>(+value));
+        }
+
+        // Bulk access for raw values, range checked once per call rather than per element.
+        // Both walk the words sequentially instead of locating every element separately.
+        void unpack(size_t first, std::span<CType> values) const {
+            Assert(first <= m_size && values.size() <= m_size - first);
+            size_t word = first * Bits / 64;
+            uint32_t offset = first * Bits % 64;
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = extend(((m_words[word] >> offset) | ((m_words[word + 1] << 1) << (63 - offset))) & Mask);
+                offset += Bits;
+                word += offset / 64;
+                offset %= 64;
+            }
+        }
+
+        // Assembles each word in a register and writes it once, only the partial words at
+        // either end are merged with the bits already stored.
+        void pack(size_t first, std::span<const CType> values) {
+            Assert(first <= m_size && values.size() <= m_size - first);
+            size_t word = first * Bits / 64;
+            uint32_t offset = first * Bits % 64;
+            uint64_t current = m_words[word] & lowBitMask(offset);
+            bool isOutOfRange = false;
+            for (size_t i = 0; i < values.size(); ++i) {
+                isOutOfRange |= values[i] < ValueType::Min || values[i] > ValueType::Max;
+                const uint64_t value = static_cast<uint64_t>(values[i]) & Mask;
+                current |= value << offset;
+                offset += Bits;
+                if (offset >= 64) {
+                    m_words[word++] = current;
+                    offset -= 64;
+                    current = offset == 0 ? 0 : value >> (Bits - offset);
+                }
+            }
+            if (offset != 0)
+                m_words[word] = current | (m_words[word] & ~lowBitMask(offset));
+            Assert(!isOutOfRange);
+        }
+
+        std::span<const uint64_t> words() const { return m_words; }
+
+    private:
+        CType load(size_t index) const {
+            const size_t bit = index * Bits;
+            const size_t word = bit / 64;
+            const uint32_t offset = bit % 64;
+
+            // (x << 1) << (63 - offset) is x << (64 - offset) without the undefined shift by 64.
+            return extend(((m_words[word] >> offset) | ((m_words[word + 1] << 1) << (63 - offset))) & Mask);
+        }
+
+        static CType extend(uint64_t raw) {
+            if constexpr (IsSigned) {
+                constexpr uint32_t Unused = 64 - Bits;
+                return static_cast<CType>(static_cast<int64_t>(raw << Unused) >> Unused);
+            } else {
+                return static_cast<CType>(raw);
+            }
+        }
+
+        void store(size_t index, uint64_t value) {
+            const size_t bit = index * Bits;
+            const size_t word = bit / 64;
+            const uint32_t offset = bit % 64;
+
+            value &= Mask;
+            m_words[word] = (m_words[word] & ~(Mask << offset)) | (value << offset);
+            if (offset + Bits > 64) {
+                const uint32_t spill = 64 - offset;
+                m_words[word + 1] = (m_words[word + 1] & ~(Mask >> spill)) | (value >> spill);
+            }
+        }
+
+        std::vector<uint64_t> m_words;
+        size_t m_size = 0;
+    };
+}
@@ -0,0 +1,183 @@
+module;
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+export module nhtypes:profiling;
+
+import :common;
+
+namespace NH_NAMESPACE {
+
+    // Keyed on the file name pointer on the hot path, each translation unit may have its own copy
+    // of the string so the report merges sites by content.
+    struct SiteKey {
+        const char * file;
+        uint32_t line;
+        uint32_t column;
+
+        friend bool operator==(SiteKey const & lhs, SiteKey const & rhs) = default;
+    };
+
+    struct SiteKeyHash {
+        size_t operator()(SiteKey const & key) const noexcept {
+            return std::hash<const char *>()(key.file) ^ (size_t(key.line) << 16) ^ key.column;
+        }
+    };
+
+    struct ReportKey {
+        std::string_view file;
+        uint32_t line;
+        uint32_t column;
+
+        friend bool operator==(ReportKey const & lhs, ReportKey const & rhs) = default;
+    };
+
+    struct ReportKeyHash {
+        size_t operator()(ReportKey const & key) const noexcept {
+            return std::hash<std::string_view>()(key.file) ^ (size_t(key.line) << 16) ^ key.column;
+        }
+    };
+
+    struct SiteStatistics {
+        const char * function = "";
+        uint64_t count = 0;
+        double maxRangeFraction = 0.0;
+    };
+
+    using SiteTable = std::unordered_map<SiteKey, SiteStatistics, SiteKeyHash>;
+    using ReportTable = std::unordered_map<ReportKey, SiteStatistics, ReportKeyHash>;
+
+    template <typename Table, typename Key = typename Table::key_type>
+    void merge(Table & target, SiteTable const & source) {
+        for (auto const & [key, statistics] : source) {
+            SiteStatistics & entry = target[Key{ key.file, key.line, key.column }];
+            entry.function = statistics.function;
+            entry.count += statistics.count;
+            entry.maxRangeFraction = std::max(entry.maxRangeFraction, statistics.maxRangeFraction);
+        }
+    }
+
+    void writeReport(ReportTable const & table, std::FILE * file) {
+        std::vector<std::pair<ReportKey, SiteStatistics>> sites(table.begin(), table.end());
+        std::sort(sites.begin(), sites.end(), [](auto const & lhs, auto const & rhs) {
+            return lhs.second.count > rhs.second.count;
+        });
+
+        std::fprintf(file, "%-60s %14s %10s  %s\n", "site", "operations", "max range", "function");
+        for (auto const & [key, statistics] : sites) {
+            std::fprintf(file, "%.*s:%u:%u %14llu %9.4f%%  %s\n", int(key.file.size()), key.file.data(), key.line, key.column,
+                static_cast<unsigned long long>(statistics.count), statistics.maxRangeFraction * 100.0, statistics.function);
+        }
+    }
+
+    // Collects the tables of finished threads and writes the report at exit.
+    // NH_OVERFLOW_PROFILE selects the output file, stderr otherwise.
+    struct GlobalProfile {
+        std::mutex mutex;
+        SiteTable table;
+
+        ~GlobalProfile() {
+            const char * path = std::getenv("NH_OVERFLOW_PROFILE");
+            std::FILE * file = path ? std::fopen(path, "w") : stderr;
+            if (!file)
+                return;
+            ReportTable report;
+            merge(report, table);
+            writeReport(report, file);
+            if (file != stderr)
+                std::fclose(file);
+        }
+    };
+
+    GlobalProfile & globalProfile() {
+        static GlobalProfile profile;
+        return profile;
+    }
+
+    // Each thread records into its own table without locking and merges once when it exits.
+    struct ThreadProfile {
+        SiteTable table;
+
+        ThreadProfile() { globalProfile(); }
+
+        ~ThreadProfile() {
+            GlobalProfile & profile = globalProfile();
+            std::lock_guard lock(profile.mutex);
+            merge(profile.table, table);
+        }
+    };
+
+    ThreadProfile & threadProfile() {
+        thread_local ThreadProfile profile;
+        return profile;
+    }
+
+    void recordOperation(std::source_location location, double rangeFraction) {
+        SiteStatistics & entry = threadProfile().table[{ location.file_name(), location.line(), location.column() }];
+        entry.function = location.function_name();
+        ++entry.count;
+        entry.maxRangeFraction = std::max(entry.maxRangeFraction, rangeFraction);
+    }
+
+    // Right hand side of a checked operator in profiling builds, the default argument
+    // captures the location of the expression that converted the operand.
+    // Mirrors m_value so the operator bodies read the same in both builds.
+    template <typename T>
+    struct ProfiledOperand {
+        decltype(+T()) m_value;
+        std::source_location location;
+
+        template <typename Other>
+        requires std::is_convertible_v<Other, T>
+        constexpr ProfiledOperand(Other other, std::source_location location = std::source_location::current())
+            : m_value(+static_cast<T>(other)), location(location) {}
+
+        constexpr operator T() const { return m_value; }
+    };
+
+    template <typename T, typename IntType>
+    constexpr inline void profileOperation(ProfiledOperand<T> const & operand, IntType result) {
+        if !consteval {
+            constexpr double Max = static_cast<double>(T::Max);
+            constexpr double Min = static_cast<double>(T::Min);
+            const double value = static_cast<double>(result);
+            recordOperation(operand.location, value < 0 ? value / Min : value / Max);
+        }
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    struct ProfiledSite {
+        std::string_view file;
+        uint32_t line;
+        uint32_t column;
+        uint64_t count;
+        double maxRangeFraction;
+    };
+
+    // Sites recorded so far by finished threads and the calling thread.
+    std::vector<ProfiledSite> overflowProfile() {
+        ReportTable report;
+        merge(report, threadProfile().table);
+        {
+            GlobalProfile & profile = globalProfile();
+            std::lock_guard lock(profile.mutex);
+            merge(report, profile.table);
+        }
+
+        std::vector<ProfiledSite> sites;
+        sites.reserve(report.size());
+        for (auto const & [key, statistics] : report)
+            sites.push_back({ key.file, key.line, key.column, statistics.count, statistics.maxRangeFraction });
+        return sites;
+    }
+}
@@ -0,0 +1,185 @@
+module;
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+export module nhtypes:reductions;
+
+import :common;
+import :integers;
+
+namespace NH_NAMESPACE {
+
+    // std::numeric_limits and the std traits don't cover int128 in strict modes.
+    template <typename Wide>
+    constexpr inline bool isSignedWide() { return Wide(-1) < Wide(0); }
+
+    template <typename Wide>
+    constexpr inline Wide maxOfWide() {
+        constexpr Wide allBits = static_cast<Wide>(~Wide(0));
+        return isSignedWide<Wide>() ? static_cast<Wide>(~(Wide(1) << (sizeof(Wide) * 8 - 1))) : allBits;
+    }
+
+    // Like std::in_range, which doesn't accept int128. The limits of Result are only
+    // cast into Wide when Wide can represent them.
+    template <typename Result, typename Wide>
+    constexpr inline bool fitsInto(Wide value) {
+        if (isSignedWide<Wide>() && value < 0) {
+            if constexpr (!std::is_signed_v<Result>)
+                return false;
+            else if constexpr (sizeof(Result) < sizeof(Wide))
+                return value >= static_cast<Wide>(std::numeric_limits<Result>::min());
+            else
+                return true;
+        }
+        if constexpr (sizeof(Result) < sizeof(Wide) || (sizeof(Result) == sizeof(Wide) && std::is_signed_v<Result> && !isSignedWide<Wide>()))
+            return value <= static_cast<Wide>(std::numeric_limits<Result>::max());
+        else
+            return true;
+    }
+
+    // Accumulator for sums (Power 1) or sums of products (Power 2) of IntType values.
+    template <typename IntType, uint32_t Power>
+    struct ReductionWide { using type = WideIntType<IntType>; };
+
+    template <typename IntType>
+    requires(sizeof(IntType) > sizeof(int16_t))
+    struct ReductionWide<IntType, 2> { using type = WideIntType<int64_t>; };
+
+#if defined(__SIZEOF_INT128__)
+    // The square of the largest uint64 only fits into the unsigned 128 bit type.
+    template <>
+    struct ReductionWide<uint64_t, 2> { using type = uint128_t; };
+#endif
+
+    // The number of terms that provably fit into the accumulator when starting from zero.
+    template <typename IntType, uint32_t Power>
+    struct ReductionTraits {
+        static_assert(Power == 1 || Power == 2);
+
+        using Wide = typename ReductionWide<IntType, Power>::type;
+        static_assert(!std::is_void_v<Wide>, "Reductions need a type wider than IntType");
+
+        static constexpr Wide Magnitude = std::max(static_cast<Wide>(std::numeric_limits<IntType>::max()),
+                                                   static_cast<Wide>(-static_cast<Wide>(std::numeric_limits<IntType>::min())));
+        static constexpr Wide TermLimit = Power == 1 ? Magnitude : Magnitude * Magnitude;
+
+        static constexpr Wide TermCount = maxOfWide<Wide>() / TermLimit;
+        static constexpr uint64_t BlockSize = sizeof(Wide) > sizeof(uint64_t) && TermCount > static_cast<Wide>(std::numeric_limits<uint64_t>::max())
+            ? std::numeric_limits<uint64_t>::max()
+            : static_cast<uint64_t>(TermCount);
+    };
+
+    // Adds term(i) for i < count to total in blocks that can't overflow the wide accumulator, so the
+    // inner loop has no branches. Only combining the blocks is checked, returns true on overflow.
+    template <typename Traits, typename Term>
+    inline bool accumulateBlocks(typename Traits::Wide & total, size_t count, Term term) {
+        using Wide = typename Traits::Wide;
+
+        bool didOverflow = false;
+        for (size_t begin = 0; begin < count;) {
+            const size_t end = begin + static_cast<size_t>(std::min<uint64_t>(Traits::BlockSize, count - begin));
+            Wide block = 0;
+            for (size_t i = begin; i < end; ++i)
+                block += term(i);
+            didOverflow |= __builtin_add_overflow(total, block, &total);
+            begin = end;
+        }
+        return didOverflow;
+    }
+
+    template <typename Result, typename Traits, typename Term>
+    inline SafeInt<Result> reduce(size_t count, Term term) {
+        typename Traits::Wide total = 0;
+        const bool didOverflow = accumulateBlocks<Traits>(total, count, term);
+        Assert(!didOverflow && fitsInto<Result>(total));
+        return static_cast<Result>(total);
+    }
+
+    template <typename Result, typename IntType>
+    using ReductionResult = std::conditional_t<std::is_void_v<Result>, IntType, Result>;
+}
+
+export namespace NH_NAMESPACE {
+
+    // Running sum that only checks once per block of BlockSize values and when reading the result.
+    template <typename IntType>
+    struct SafeAccumulator
+    {
+        using Traits = ReductionTraits<IntType, 1>;
+        using Wide = typename Traits::Wide;
+
+        static constexpr uint64_t BlockSize = Traits::BlockSize;
+
+        constexpr SafeAccumulator & operator+=(SafeInt<IntType> value) {
+            m_block += +value;
+            if (++m_count == BlockSize)
+                flush();
+            return *this;
+        }
+
+        // Tops up the open block, the rest is added to the total in whole blocks.
+        SafeAccumulator & operator+=(std::span<const SafeInt<IntType>> values) {
+            const size_t head = static_cast<size_t>(std::min<uint64_t>(BlockSize - m_count, values.size()));
+            for (size_t i = 0; i < head; ++i)
+                m_block += +values[i];
+            m_count += head;
+            if (m_count == BlockSize)
+                flush();
+
+            const auto rest = values.subspan(head);
+            Assert(!accumulateBlocks<Traits>(m_total, rest.size(), [rest](size_t i) { return static_cast<Wide>(+rest[i]); }));
+            return *this;
+        }
+
+        // Asserts if the sum doesn't fit into Result (IntType by default).
+        template <typename Result = IntType>
+        constexpr SafeInt<Result> result() const {
+            Wide total = m_total;
+            const bool didOverflow = __builtin_add_overflow(total, m_block, &total);
+            Assert(!didOverflow && fitsInto<Result>(total));
+            return static_cast<Result>(total);
+        }
+
+    private:
+        constexpr void flush() {
+            Assert(!__builtin_add_overflow(m_total, m_block, &m_total));
+            m_block = 0;
+            m_count = 0;
+        }
+
+        Wide m_total = 0;
+        Wide m_block = 0;
+        uint64_t m_count = 0;
+    };
+
+    // Span reductions, the result is narrowed to Result (the element type by default) once at the end.
+
+    template <typename Result = void, typename IntType>
+    inline SafeInt<ReductionResult<Result, IntType>> sum(std::span<const SafeInt<IntType>> values) {
+        using Traits = ReductionTraits<IntType, 1>;
+        return reduce<ReductionResult<Result, IntType>, Traits>(values.size(), [values](size_t i) {
+            return static_cast<typename Traits::Wide>(+values[i]);
+        });
+    }
+
+    template <typename Result = void, typename IntType>
+    inline SafeInt<ReductionResult<Result, IntType>> sumOfSquares(std::span<const SafeInt<IntType>> values) {
+        using Traits = ReductionTraits<IntType, 2>;
+        return reduce<ReductionResult<Result, IntType>, Traits>(values.size(), [values](size_t i) {
+            const auto value = static_cast<typename Traits::Wide>(+values[i]);
+            return value * value;
+        });
+    }
+
+    template <typename Result = void, typename IntType>
+    inline SafeInt<ReductionResult<Result, IntType>> dot(std::span<const SafeInt<IntType>> lhs, std::span<const SafeInt<IntType>> rhs) {
+        using Traits = ReductionTraits<IntType, 2>;
+        Assert(lhs.size() == rhs.size());
+        return reduce<ReductionResult<Result, IntType>, Traits>(lhs.size(), [lhs, rhs](size_t i) {
+            return static_cast<typename Traits::Wide>(+lhs[i]) * static_cast<typename Traits::Wide>(+rhs[i]);
+        });
+    }
+}
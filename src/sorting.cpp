@@ -0,0 +1,178 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+export module nhtypes:sorting;
+
+import :common;
+import :integers;
+import :decimals;
+
+namespace NH_NAMESPACE {
+
+    template <size_t Size> struct UnsignedOfSize;
+    template <> struct UnsignedOfSize<1> { using type = uint8_t; };
+    template <> struct UnsignedOfSize<2> { using type = uint16_t; };
+    template <> struct UnsignedOfSize<4> { using type = uint32_t; };
+    template <> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+    // Flipping the sign bit maps two's complement onto unsigned order.
+    template <typename IntType>
+    constexpr inline std::make_unsigned_t<IntType> integerKey(IntType value) {
+        using Key = std::make_unsigned_t<IntType>;
+        if constexpr (std::is_signed_v<IntType>)
+            return static_cast<Key>(static_cast<Key>(value) ^ (Key(1) << (sizeof(Key) * 8 - 1)));
+        else
+            return value;
+    }
+
+    // IEEE 754 totalOrder: negative values have all bits flipped, positive ones only the sign bit.
+    template <typename ValueType>
+    constexpr inline auto decimalKey(ValueType value) {
+        using Key = typename UnsignedOfSize<sizeof(ValueType)>::type;
+        constexpr Key SignBit = Key(1) << (sizeof(Key) * 8 - 1);
+        const Key bits = std::bit_cast<Key>(value);
+        return static_cast<Key>((bits & SignBit) ? ~bits : (bits | SignBit));
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    // Unsigned keys whose order matches the order of the values, used by radixSort.
+    template <typename IntType>
+    constexpr inline auto sortKey(SafeInt<IntType> value) { return integerKey(+value); }
+
+    template <typename IntType>
+    constexpr inline auto sortKey(FastInt<IntType> value) { return integerKey(+value); }
+
+    template <typename ValueType>
+    constexpr inline auto sortKey(SafeDecimal<ValueType> value) { return decimalKey(+value); }
+
+    template <typename ValueType>
+    constexpr inline auto sortKey(FastDecimal<ValueType> value) { return decimalKey(+value); }
+
+    template <typename T>
+    concept isRadixSortable = requires(T value) {
+        { sortKey(value) } -> std::unsigned_integral;
+    };
+}
+
+namespace NH_NAMESPACE {
+
+    // Below this many elements per thread spawning threads costs more than it saves.
+    inline constexpr size_t MinimumElementsPerThread = size_t(1) << 16;
+
+    template <typename Function>
+    void runParallel(size_t threadCount, Function function) {
+        std::vector<std::jthread> threads;
+        threads.reserve(threadCount - 1);
+        for (size_t thread = 1; thread < threadCount; ++thread)
+            threads.emplace_back(function, thread);
+        function(size_t(0));
+    }
+
+    // Stable LSD radix sort over 8 bit digits. Every pass histograms and scatters one chunk per
+    // thread, passes where all keys share the digit are skipped.
+    template <typename Element, typename KeyOf>
+    void radixSortBy(std::span<Element> data, KeyOf keyOf, size_t threadCount) {
+        using Key = decltype(keyOf(data[0]));
+        constexpr size_t Radix = 256;
+
+        const size_t count = data.size();
+        if (count < 2)
+            return;
+
+        threadCount = std::clamp<size_t>(std::min(threadCount, count / MinimumElementsPerThread), 1, 256);
+
+        std::vector<Element> buffer(count);
+        std::span<Element> source = data;
+        std::span<Element> target = buffer;
+        std::vector<std::array<size_t, Radix>> histograms(threadCount);
+
+        for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+            const auto digitOf = [&](Element const & element) {
+                return static_cast<size_t>((keyOf(element) >> shift) & (Radix - 1));
+            };
+            const auto chunkBegin = [&](size_t thread) { return count * thread / threadCount; };
+
+            runParallel(threadCount, [&](size_t thread) {
+                std::array<size_t, Radix> & histogram = histograms[thread];
+                histogram.fill(0);
+                for (size_t i = chunkBegin(thread); i < chunkBegin(thread + 1); ++i)
+                    ++histogram[digitOf(source[i])];
+            });
+
+            // Turn the counts into exclusive offsets, digit major so equal keys keep their order.
+            bool isSingleBucket = false;
+            size_t offset = 0;
+            for (size_t digit = 0; digit < Radix; ++digit) {
+                const size_t bucketBegin = offset;
+                for (std::array<size_t, Radix> & histogram : histograms) {
+                    const size_t bucketCount = histogram[digit];
+                    histogram[digit] = offset;
+                    offset += bucketCount;
+                }
+                isSingleBucket |= offset - bucketBegin == count;
+            }
+            if (isSingleBucket)
+                continue;
+
+            runParallel(threadCount, [&](size_t thread) {
+                std::array<size_t, Radix> & offsets = histograms[thread];
+                for (size_t i = chunkBegin(thread); i < chunkBegin(thread + 1); ++i)
+                    target[offsets[digitOf(source[i])]++] = source[i];
+            });
+
+            std::swap(source, target);
+        }
+
+        if (source.data() != data.data())
+            std::copy(source.begin(), source.end(), data.begin());
+    }
+}
+
+export namespace NH_NAMESPACE {
+
+    // Sorts ascending by sortKey, which for SafeDecimal is the IEEE total order rather than the
+    // epsilon comparison of its operators. Stable.
+    template <std::ranges::contiguous_range Range>
+    requires isRadixSortable<std::ranges::range_value_t<Range>>
+    void radixSort(Range && values, size_t threadCount = std::thread::hardware_concurrency()) {
+        using Element = std::ranges::range_value_t<Range>;
+        radixSortBy(std::span<Element>(std::ranges::data(values), std::ranges::size(values)),
+                    [](Element const & element) { return sortKey(element); }, threadCount);
+    }
+
+    // Indices that would sort values, equal values keep their relative order.
+    template <std::ranges::contiguous_range Range>
+    requires isRadixSortable<std::ranges::range_value_t<Range>>
+    std::vector<size_t> argsort(Range const & values, size_t threadCount = std::thread::hardware_concurrency()) {
+        using Key = decltype(sortKey(std::declval<std::ranges::range_value_t<Range>>()));
+        struct KeyedIndex {
+            Key key;
+            size_t index;
+        };
+
+        const size_t count = std::ranges::size(values);
+        const auto * data = std::ranges::data(values);
+
+        std::vector<KeyedIndex> keyed(count);
+        for (size_t i = 0; i < count; ++i)
+            keyed[i] = { sortKey(data[i]), i };
+
+        radixSortBy(std::span<KeyedIndex>(keyed), [](KeyedIndex const & element) { return element.key; }, threadCount);
+
+        std::vector<size_t> indices(count);
+        for (size_t i = 0; i < count; ++i)
+            indices[i] = keyed[i].index;
+        return indices;
+    }
+}
@@ -1,29 +1,191 @@
 module;
 
+#include <algorithm>
 #include <limits>
+#include <type_traits>
 
 export module nhtypes:type_traits;
 
 import :integers;
 import :boolean;
 import :decimals;
+import :packed;
 
-#define CREATE_TYPE_TRAITS_TEMPLATE_FOR_HELIUM_TYPE(HeType)                                    \
-    template<typename T>                                                                       \
-    class numeric_limits<HeType<T>> {                                                          \
+// Safe types never wrap and can't hold infinity or NaN, so they don't advertise them.
+// The special values are still provided (as zero) like for the integral types.
+#define CREATE_NUMERIC_LIMITS_FOR_HELIUM_TYPE(HeType, Limits, IsSafe)                          \
+    template <typename T>                                                                      \
+    class numeric_limits<HeType<T>> : public Limits<T> {                                       \
     public:                                                                                    \
-        static constexpr HeType<T> min() { return std::numeric_limits<T>::min(); }             \
-        static constexpr HeType<T> max() { return std::numeric_limits<T>::max(); }             \
-\
-        static constexpr bool is_real = std::numeric_limits<T>::is_real;  \
-        static constexpr bool is_signed = std::numeric_limits<T>::is_signed; \
-        static constexpr bool is_integer = std::numeric_limits<T>::is_integer; \
+        static constexpr bool is_modulo = !IsSafe && Limits<T>::is_modulo;                     \
+        static constexpr bool has_infinity = !IsSafe && Limits<T>::has_infinity;               \
+        static constexpr bool has_quiet_NaN = !IsSafe && Limits<T>::has_quiet_NaN;             \
+        static constexpr bool has_signaling_NaN = !IsSafe && Limits<T>::has_signaling_NaN;     \
+        static constexpr bool is_iec559 = !IsSafe && Limits<T>::is_iec559;                     \
                                                                                                \
-        static bool is_specialized() { return true; }                                          \
-    };  \
+        static constexpr HeType<T> min() noexcept { return Limits<T>::min(); }                 \
+        static constexpr HeType<T> max() noexcept { return Limits<T>::max(); }                 \
+        static constexpr HeType<T> lowest() noexcept { return Limits<T>::lowest(); }           \
+        static constexpr HeType<T> epsilon() noexcept { return Limits<T>::epsilon(); }         \
+        static constexpr HeType<T> round_error() noexcept { return Limits<T>::round_error(); } \
+        static constexpr HeType<T> denorm_min() noexcept { return Limits<T>::denorm_min(); }   \
+        static constexpr HeType<T> infinity() noexcept {                                       \
+            return has_infinity ? HeType<T>(Limits<T>::infinity()) : HeType<T>();              \
+        }                                                                                      \
+        static constexpr HeType<T> quiet_NaN() noexcept {                                      \
+            return has_quiet_NaN ? HeType<T>(Limits<T>::quiet_NaN()) : HeType<T>();            \
+        }                                                                                      \
+        static constexpr HeType<T> signaling_NaN() noexcept {                                  \
+            return has_signaling_NaN ? HeType<T>(Limits<T>::signaling_NaN()) : HeType<T>();    \
+        }                                                                                      \
+    };
 
 export namespace std {
 
-//CREATE_TYPE_TRAITS_TEMPLATE_FOR_HELIUM_TYPE(he::SafeSignedInt)
-//CREATE_TYPE_TRAITS_TEMPLATE_FOR_HELIUM_TYPE(he::FastInt)
+CREATE_NUMERIC_LIMITS_FOR_HELIUM_TYPE(NH_NAMESPACE::SafeInt, numeric_limits, true)
+CREATE_NUMERIC_LIMITS_FOR_HELIUM_TYPE(NH_NAMESPACE::SafeDecimal, NH_NAMESPACE::DecimalLimits, true)
+CREATE_NUMERIC_LIMITS_FOR_HELIUM_TYPE(NH_NAMESPACE::FastInt, numeric_limits, false)
+CREATE_NUMERIC_LIMITS_FOR_HELIUM_TYPE(NH_NAMESPACE::FastDecimal, NH_NAMESPACE::DecimalLimits, false)
+
+    template <NH_NAMESPACE::uint32_t Bits, bool IsSigned>
+    class numeric_limits<NH_NAMESPACE::SafeBitInt<Bits, IsSigned>> : public numeric_limits<typename NH_NAMESPACE::SafeBitInt<Bits, IsSigned>::CType> {
+        using Type = NH_NAMESPACE::SafeBitInt<Bits, IsSigned>;
+    public:
+        static constexpr int digits = Bits - IsSigned;
+        static constexpr int digits10 = digits * 643 / 2136; // log10(2) ~ 643 / 2136
+        static constexpr bool is_modulo = false;
+
+        static constexpr Type min() noexcept { return Type::Min; }
+        static constexpr Type max() noexcept { return Type::Max; }
+        static constexpr Type lowest() noexcept { return Type::Min; }
+        static constexpr Type epsilon() noexcept { return Type(); }
+        static constexpr Type round_error() noexcept { return Type(); }
+        static constexpr Type denorm_min() noexcept { return Type(); }
+        static constexpr Type infinity() noexcept { return Type(); }
+        static constexpr Type quiet_NaN() noexcept { return Type(); }
+        static constexpr Type signaling_NaN() noexcept { return Type(); }
+    };
+}
+
+namespace NH_NAMESPACE {
+
+    // The common type of two helium types is the one the other implicitly converts to,
+    // so it follows the library's (lossless) conversion rules instead of integer promotion.
+    template <typename Lhs, typename Rhs>
+    struct HeliumCommonType {};
+
+    template <typename Lhs, typename Rhs>
+    requires std::is_convertible_v<Lhs, Rhs>
+    struct HeliumCommonType<Lhs, Rhs> { using type = Rhs; };
+
+    template <typename Lhs, typename Rhs>
+    requires(!std::is_convertible_v<Lhs, Rhs> && std::is_convertible_v<Rhs, Lhs>)
+    struct HeliumCommonType<Lhs, Rhs> { using type = Lhs; };
+}
+
+namespace NH_NAMESPACE {
+
+    // Bit width integers widen to hold both operands, an unsigned operand needs one more
+    // bit in a signed result. There is no common type beyond 64 bits.
+    template <uint32_t Bits, bool IsSigned>
+    struct BitIntCommonType {};
+
+    template <uint32_t Bits, bool IsSigned>
+    requires(Bits <= 64)
+    struct BitIntCommonType<Bits, IsSigned> { using type = SafeBitInt<Bits, IsSigned>; };
+
+    template <uint32_t LhsBits, bool LhsSigned, uint32_t RhsBits, bool RhsSigned>
+    constexpr uint32_t CommonBits = std::max(LhsBits + (RhsSigned && !LhsSigned), RhsBits + (LhsSigned && !RhsSigned));
+}
+
+#define CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(LhsType, RhsType)                                  \
+    template <typename Lhs, typename Rhs>                                                      \
+    struct common_type<LhsType<Lhs>, RhsType<Rhs>>                                             \
+        : NH_NAMESPACE::HeliumCommonType<LhsType<Lhs>, RhsType<Rhs>> {};
+
+export namespace std {
+
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::SafeInt, NH_NAMESPACE::SafeInt)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::SafeInt, NH_NAMESPACE::FastInt)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::FastInt, NH_NAMESPACE::SafeInt)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::FastInt, NH_NAMESPACE::FastInt)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::SafeDecimal, NH_NAMESPACE::SafeDecimal)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::SafeDecimal, NH_NAMESPACE::FastDecimal)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::FastDecimal, NH_NAMESPACE::SafeDecimal)
+CREATE_COMMON_TYPE_FOR_HELIUM_TYPES(NH_NAMESPACE::FastDecimal, NH_NAMESPACE::FastDecimal)
+
+    template <NH_NAMESPACE::uint32_t LhsBits, bool LhsSigned, NH_NAMESPACE::uint32_t RhsBits, bool RhsSigned>
+    struct common_type<NH_NAMESPACE::SafeBitInt<LhsBits, LhsSigned>, NH_NAMESPACE::SafeBitInt<RhsBits, RhsSigned>>
+        : NH_NAMESPACE::BitIntCommonType<NH_NAMESPACE::CommonBits<LhsBits, LhsSigned, RhsBits, RhsSigned>, LhsSigned || RhsSigned> {};
+
+    // Mixed with SafeInt, a bit width integer takes part as the SafeInt of its storage type.
+    template <NH_NAMESPACE::uint32_t Bits, bool IsSigned, typename IntType>
+    struct common_type<NH_NAMESPACE::SafeBitInt<Bits, IsSigned>, NH_NAMESPACE::SafeInt<IntType>>
+        : common_type<NH_NAMESPACE::SafeInt<typename NH_NAMESPACE::SafeBitInt<Bits, IsSigned>::CType>, NH_NAMESPACE::SafeInt<IntType>> {};
+
+    template <typename IntType, NH_NAMESPACE::uint32_t Bits, bool IsSigned>
+    struct common_type<NH_NAMESPACE::SafeInt<IntType>, NH_NAMESPACE::SafeBitInt<Bits, IsSigned>>
+        : common_type<NH_NAMESPACE::SafeInt<IntType>, NH_NAMESPACE::SafeInt<typename NH_NAMESPACE::SafeBitInt<Bits, IsSigned>::CType>> {};
+}
+
+export namespace NH_NAMESPACE {
+
+    // std::make_signed/make_unsigned may not be specialized for program defined types.
+    template <typename T>
+    struct make_signed;
+
+    template <typename T>
+    struct make_unsigned;
+
+    template <typename IntType>
+    struct make_signed<SafeInt<IntType>> { using type = SafeInt<std::make_signed_t<IntType>>; };
+
+    template <typename IntType>
+    struct make_signed<FastInt<IntType>> { using type = FastInt<std::make_signed_t<IntType>>; };
+
+    template <uint32_t Bits, bool IsSigned>
+    struct make_signed<SafeBitInt<Bits, IsSigned>> { using type = SafeBitInt<Bits, true>; };
+
+    template <typename IntType>
+    struct make_unsigned<SafeInt<IntType>> { using type = SafeInt<std::make_unsigned_t<IntType>>; };
+
+    template <typename IntType>
+    struct make_unsigned<FastInt<IntType>> { using type = FastInt<std::make_unsigned_t<IntType>>; };
+
+    template <uint32_t Bits, bool IsSigned>
+    struct make_unsigned<SafeBitInt<Bits, IsSigned>> { using type = SafeBitInt<Bits, false>; };
+
+    template <typename T>
+    using make_signed_t = typename make_signed<T>::type;
+
+    template <typename T>
+    using make_unsigned_t = typename make_unsigned<T>::type;
+}
+
+namespace NH_NAMESPACE {
+
+    // Wrappers must stay a plain value so std algorithms and containers can use memcpy/memmove
+    // and templated kernels can reinterpret spans of them as spans of the underlying type.
+    template <typename T, typename CType>
+    constexpr bool isPlainWrapper = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> &&
+                                    sizeof(T) == sizeof(CType) && alignof(T) == alignof(CType);
+
+    static_assert(isPlainWrapper<SafeI8, int8_t> && isPlainWrapper<FastI8, int8_t>);
+    static_assert(isPlainWrapper<SafeI16, int16_t> && isPlainWrapper<FastI16, int16_t>);
+    static_assert(isPlainWrapper<SafeI32, int32_t> && isPlainWrapper<FastI32, int32_t>);
+    static_assert(isPlainWrapper<SafeI64, int64_t> && isPlainWrapper<FastI64, int64_t>);
+    static_assert(isPlainWrapper<SafeU8, uint8_t> && isPlainWrapper<FastU8, uint8_t>);
+    static_assert(isPlainWrapper<SafeU16, uint16_t> && isPlainWrapper<FastU16, uint16_t>);
+    static_assert(isPlainWrapper<SafeU32, uint32_t> && isPlainWrapper<FastU32, uint32_t>);
+    static_assert(isPlainWrapper<SafeU64, uint64_t> && isPlainWrapper<FastU64, uint64_t>);
+    static_assert(isPlainWrapper<SafeFloat, float> && isPlainWrapper<FastFloat, float>);
+    static_assert(isPlainWrapper<SafeDouble, double> && isPlainWrapper<FastDouble, double>);
+    static_assert(isPlainWrapper<SafeUInt<12>, uint16_t> && isPlainWrapper<SafeSInt<20>, int32_t>);
+    static_assert(isPlainWrapper<Bool, bool>);
+#if defined(HAS_HALF_DECIMAL)
+    static_assert(isPlainWrapper<SafeHalf, SafeHalf::CType> && isPlainWrapper<FastHalf, FastHalf::CType>);
+#endif
+#if defined(HAS_BFLOAT16_DECIMAL)
+    static_assert(isPlainWrapper<SafeBFloat16, SafeBFloat16::CType> && isPlainWrapper<FastBFloat16, FastBFloat16::CType>);
+#endif
 }
@@ -9,11 +9,27 @@ export import :boolean;
 export import :integers;
 export import :decimals;
 export import :type_traits;
+export import :column;
+export import :math;
+export import :profiling;
+export import :reductions;
+export import :sorting;
+export import :expressions;
+export import :packed;
+export import :wire;
+export import :arena;
 
 export namespace NH_NAMESPACE {
 
+template <typename T>
+inline constexpr bool isBitWidthInteger = false;
+
+template <uint32_t Bits, bool IsSigned>
+inline constexpr bool isBitWidthInteger<SafeBitInt<Bits, IsSigned>> = true;
+
 template <typename T>
 concept isHeliumInteger =
+    isBitWidthInteger<T> ||
     std::is_same_v<T, SafeI8> || std::is_same_v<T, SafeI16> ||
     std::is_same_v<T, SafeI32> || std::is_same_v<T, SafeI64> ||
     std::is_same_v<T, SafeU8> || std::is_same_v<T, SafeU16> ||
@@ -26,8 +42,25 @@ concept isHeliumInteger =
 template <typename T>
 concept isHeliumDecimal =
     std::is_same_v<T, FastFloat> || std::is_same_v<T, FastDouble> ||
-    std::is_same_v<T, SafeFloat> || std::is_same_v<T, SafeDouble>;
+    std::is_same_v<T, SafeFloat> || std::is_same_v<T, SafeDouble>
+#if defined(HAS_HALF_DECIMAL)
+    || std::is_same_v<T, FastHalf> || std::is_same_v<T, SafeHalf>
+#endif
+#if defined(HAS_BFLOAT16_DECIMAL)
+    || std::is_same_v<T, FastBFloat16> || std::is_same_v<T, SafeBFloat16>
+#endif
+    ;
 
 template <typename T>
 concept isHeliumNumber = isHeliumInteger<T> || isHeliumDecimal<T>;
+
+// std::is_arithmetic may not be specialized, use these in generic code instead.
+template <typename T>
+concept isArithmetic = std::is_arithmetic_v<T> || isHeliumNumber<T>;
+
+template <typename T>
+concept isIntegral = std::is_integral_v<T> || isHeliumInteger<T>;
+
+template <typename T>
+concept isFloatingPoint = std::is_floating_point_v<T> || isHeliumDecimal<T>;
 } // namespace nh
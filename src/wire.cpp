@@ -0,0 +1,124 @@
+module;
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+export module nhtypes:wire;
+
+import :common;
+import :integers;
+import :decimals;
+
+namespace NH_NAMESPACE {
+
+    template <typename T>
+    using WireCType = std::remove_cvref_t<decltype(+std::declval<T>())>;
+
+    template <typename ValueType>
+    inline ValueType byteswapValue(ValueType value) {
+        if constexpr (std::is_integral_v<ValueType>) {
+            return std::byteswap(value);
+        } else {
+            using Bits = std::conditional_t<sizeof(ValueType) == 2, uint16_t, std::conditional_t<sizeof(ValueType) == 4, uint32_t, uint64_t>>;
+            return std::bit_cast<ValueType>(std::byteswap(std::bit_cast<Bits>(value)));
+        }
+    }
+
+    template <typename T>
+    concept hasWireFields = requires(T const & value) { value.fields(); };
+}
+
+export namespace NH_NAMESPACE {
+
+    // Unaligned value stored in Order byte order, e.g. inside a packet header overlaid on a
+    // receive buffer. Reading converts to T, which performs T's usual checks.
+    template <typename T, std::endian Order>
+    struct WireValue
+    {
+        using ValueType = T;
+        using CType = WireCType<T>;
+
+        WireValue() = default;
+        WireValue(T value) { store(+value); }
+
+        WireValue & operator=(T value) { store(+value); return *this; }
+
+        operator T() const { return T(raw()); }
+        T load() const { return T(raw()); }
+
+        CType raw() const {
+            CType value;
+            std::memcpy(&value, m_bytes, sizeof(CType));
+            if constexpr (Order != std::endian::native)
+                value = byteswapValue(value);
+            return value;
+        }
+
+        // Whether converting to T would pass its checks, without asserting.
+        bool isValid() const {
+            const CType value = raw();
+            if constexpr (std::is_same_v<T, SafeDecimal<CType>>)
+                return !isInfinityOrNan(value);
+            else if constexpr (std::is_floating_point_v<CType> || std::is_same_v<T, FastDecimal<CType>>)
+                return true;
+            else
+                return value >= T::Min && value <= T::Max;
+        }
+
+    private:
+        void store(CType value) {
+            if constexpr (Order != std::endian::native)
+                value = byteswapValue(value);
+            std::memcpy(m_bytes, &value, sizeof(CType));
+        }
+
+        std::byte m_bytes[sizeof(CType)];
+    };
+
+    template <typename T>
+    using BigEndian = WireValue<T, std::endian::big>;
+
+    template <typename T>
+    using LittleEndian = WireValue<T, std::endian::little>;
+
+    // Checks every field of a wire struct that lists them via fields() (e.g. returning std::tie(...)),
+    // asserting once for the whole struct.
+    template <typename Header>
+    requires hasWireFields<Header>
+    inline bool isValid(Header const & header) {
+        return std::apply([](auto const &... fields) { return (fields.isValid() & ...); }, header.fields());
+    }
+
+    template <typename Header>
+    requires hasWireFields<Header>
+    inline void validate(Header const & header) {
+        Assert(isValid(header));
+    }
+
+    // Overlays Header on the start of buffer without copying. Header must consist of wire
+    // values (alignment 1). The buffer is received data, so a short buffer or a struct with
+    // fields() that fails validation gives null instead of asserting.
+    template <typename Header>
+    requires(std::is_trivially_copyable_v<Header> && alignof(Header) == 1)
+    inline Header const * wireView(std::span<const std::byte> buffer) {
+        if (buffer.size() < sizeof(Header))
+            return nullptr;
+        Header const * header = reinterpret_cast<Header const *>(buffer.data());
+        if constexpr (hasWireFields<Header>) {
+            if (!isValid(*header))
+                return nullptr;
+        }
+        return header;
+    }
+
+    template <typename Header>
+    requires(std::is_trivially_copyable_v<Header> && alignof(Header) == 1)
+    inline Header * wireView(std::span<std::byte> buffer) {
+        return const_cast<Header *>(wireView<Header>(std::span<const std::byte>(buffer)));
+    }
+}
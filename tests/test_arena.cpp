@@ -0,0 +1,89 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+export module test.arena;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test SafeArena")
+{
+    alignas(64) std::byte buffer[256];
+    SafeArena arena(buffer);
+
+    SECTION("Bump allocation")
+    {
+        char * first = arena.allocate<char>(SafeSize(3));
+        REQUIRE(first == reinterpret_cast<char *>(buffer));
+        REQUIRE(+arena.used() == 3);
+
+        // Padded up to the alignment of the next type.
+        uint64_t * second = arena.allocate<uint64_t>(SafeSize(2));
+        REQUIRE(reinterpret_cast<std::byte *>(second) == buffer + 8);
+        REQUIRE(+arena.used() == 24);
+        REQUIRE(+arena.remaining() == 232);
+
+        void * aligned = arena.allocate(SafeSize(1), SafeSize(64));
+        REQUIRE(aligned == buffer + 64);
+
+        arena.reset();
+        REQUIRE(+arena.used() == 0);
+        REQUIRE(arena.allocate<char>() == reinterpret_cast<char *>(buffer));
+    }
+
+    SECTION("Exhaustion and overflow")
+    {
+        REQUIRE(arena.allocate<std::byte>(SafeSize(256)) == buffer);
+        REQUIRE_THROWS_AS(arena.allocate<std::byte>(), std::bad_alloc);
+        arena.reset();
+
+        REQUIRE_THROWS_AS(arena.allocate<uint32_t>(SafeSize(65)), std::bad_alloc);
+        // count * sizeof(T) wraps in size_t but not in the checked computation.
+        REQUIRE_THROWS_AS(arena.allocate<uint64_t>(SafeSize(std::numeric_limits<size_t>::max() / 4)), std::bad_alloc);
+        REQUIRE_THROWS(arena.allocate(SafeSize(1), SafeSize(3)));
+        REQUIRE(+arena.used() == 0);
+    }
+
+    SECTION("Running out of space")
+    {
+        // A failed allocation leaves the arena unchanged, so the space that is left stays usable.
+        arena.allocate<char>(SafeSize(250));
+        REQUIRE_THROWS_AS(arena.allocate<uint64_t>(), std::bad_alloc);
+        REQUIRE(+arena.used() == 250);
+        REQUIRE_THROWS_AS(arena.allocate<char>(SafeSize(7)), std::bad_alloc);
+        REQUIRE(arena.allocate<char>(SafeSize(6)) == reinterpret_cast<char *>(buffer) + 250);
+        REQUIRE(+arena.remaining() == 0);
+        REQUIRE_THROWS_AS(arena.allocate<char>(), std::bad_alloc);
+    }
+
+    SECTION("Batch creation")
+    {
+        auto values = arena.create<SafeI32>(SafeSize(10), SafeI32(7));
+        REQUIRE(values.size() == 10);
+        REQUIRE(+values[9] == 7);
+        REQUIRE(+arena.used() == 40);
+        REQUIRE_THROWS_AS(arena.create<SafeI32>(SafeSize(60), SafeI32(0)), std::bad_alloc);
+    }
+
+    SECTION("memory_resource adapter")
+    {
+        SafeArenaResource resource(arena);
+        std::pmr::vector<int32_t> values(&resource);
+        for (int32_t i = 0; i < 8; ++i)
+            values.push_back(i);
+        REQUIRE(values[7] == 7);
+        REQUIRE(+arena.used() > 0);
+        const SafeSize used = arena.used();
+        REQUIRE_THROWS_AS(values.resize(1000), std::bad_alloc);
+        REQUIRE(+arena.used() == +used);
+        REQUIRE_THROWS_AS(resource.allocate(1024), std::bad_alloc);
+    }
+}
@@ -0,0 +1,75 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+
+export module test.column;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test SafeColumn")
+{
+    SafeColumn<SafeI32> column;
+    for (int64_t i = 0; i < 5000; ++i)
+        column.push_back(SafeI32(i - 2500));
+
+    SECTION("Zone maps")
+    {
+        REQUIRE(column.blockCount() == 5);
+        REQUIRE(column.zone(0).min == -2500);
+        REQUIRE(column.zone(0).max == -2500 + 1023);
+    }
+
+    SECTION("Sum")
+    {
+        REQUIRE(+column.sum() == -2500);
+
+        column.set(10, SafeI32(std::numeric_limits<int32_t>::max()));
+        REQUIRE_NOTHROW(column.sum());
+        column.set(4000, SafeI32(std::numeric_limits<int32_t>::max()));
+        REQUIRE_THROWS(column.sum());
+    }
+
+    SECTION("Scale")
+    {
+        REQUIRE_NOTHROW(column.scale(SafeI32(3)));
+        REQUIRE(+column[4999] == 3 * 2499);
+        REQUIRE(column.zone(4).max == 3 * 2499);
+
+        column.set(10, SafeI32(std::numeric_limits<int32_t>::max()));
+        REQUIRE_THROWS(column.scale(SafeI32(2)));
+    }
+
+    SECTION("Narrow")
+    {
+        REQUIRE(+column.narrow<int16_t>()[0] == -2500);
+        REQUIRE_THROWS(column.narrow<int8_t>());
+    }
+}
+
+TEST_CASE("Test SafeColumn scale bounds")
+{
+    SECTION("Stale bounds")
+    {
+        SafeColumn<SafeI32> column;
+        column.push_back(SafeI32(1));
+        column.set(0, SafeI32(std::numeric_limits<int32_t>::max()));
+        column.set(0, SafeI32(0));
+        REQUIRE_NOTHROW(column.scale(SafeI32(2)));
+        REQUIRE(column.zone(0).max == 0);
+        REQUIRE_NOTHROW(column.scale(SafeI32(2)));
+    }
+
+    SECTION("Unsigned products")
+    {
+        SafeColumn<SafeU32> narrow;
+        narrow.push_back(SafeU32(4000000000u));
+        REQUIRE_THROWS(narrow.scale(SafeU32(4000000000u)));
+
+        SafeColumn<SafeU64> wide;
+        wide.push_back(SafeU64(std::numeric_limits<uint64_t>::max()));
+        REQUIRE_THROWS(wide.scale(SafeU64(std::numeric_limits<uint64_t>::max())));
+    }
+}
@@ -9,8 +9,8 @@ import nhtypes;
 
 #define Make_Safe_Decimal_Tests(Type, CType)                             \
     TEST_CASE("Test " #Type) {                                           \
-        constexpr CType Min = std::numeric_limits<CType>::min();         \
-        constexpr CType Max = std::numeric_limits<CType>::max();         \
+        constexpr CType Min = +std::numeric_limits<Type>::min();         \
+        constexpr CType Max = +std::numeric_limits<Type>::max();         \
         constexpr CType Inf = std::numeric_limits<CType>::infinity();    \
         constexpr auto  NaN = NAN;                                       \
                                                                          \
@@ -22,3 +22,49 @@ import nhtypes;
     }
 
 Make_Safe_Decimal_Tests(nh::SafeFloat, float);
+
+#if defined(HAS_HALF_DECIMAL)
+Make_Safe_Decimal_Tests(nh::SafeHalf, nh::SafeHalf::CType);
+
+TEST_CASE("Convert between half and float") {
+    REQUIRE(+std::numeric_limits<nh::SafeHalf>::max() == 65504.0f);
+    REQUIRE(+std::numeric_limits<nh::SafeHalf>::epsilon() == 0.0009765625f);
+    REQUIRE_NOTHROW(nh::SafeFloat(nh::SafeHalf(1.5f)));
+    REQUIRE_NOTHROW(nh::SafeHalf(nh::SafeFloat(65504.0f)));
+    REQUIRE_THROWS(nh::SafeHalf(nh::SafeFloat(1e6f)));
+
+    nh::SafeFloat wide[9] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+    nh::SafeHalf narrow[9];
+    REQUIRE_NOTHROW(nh::narrow(wide, narrow));
+    REQUIRE_NOTHROW(nh::widen(narrow, wide));
+    REQUIRE(wide[8] == nh::SafeFloat(8.0f));
+
+    wide[8] = 1e6f;
+    REQUIRE_THROWS(nh::narrow(wide, narrow));
+    REQUIRE(narrow[8] == nh::SafeHalf(0.0f));
+
+    wide[8] = 8.0f;
+    wide[3] = -1e6f;
+    REQUIRE_THROWS(nh::narrow(wide, narrow));
+    REQUIRE(narrow[3] == nh::SafeHalf(0.0f));
+    REQUIRE(narrow[8] == nh::SafeHalf(8.0f));
+}
+#endif
+
+#if defined(HAS_BFLOAT16_DECIMAL)
+TEST_CASE("Convert between bfloat16 and float") {
+    REQUIRE_NOTHROW(nh::SafeFloat(nh::SafeBFloat16(1.5f)));
+    REQUIRE_NOTHROW(nh::SafeBFloat16(nh::SafeFloat(1e38f)));
+    REQUIRE_THROWS(nh::SafeBFloat16(nh::SafeFloat(std::numeric_limits<float>::max())));
+
+    nh::SafeFloat wide[3] = { 0.5f, 1.0f, 2.0f };
+    nh::SafeBFloat16 narrow[3];
+    REQUIRE_NOTHROW(nh::narrow(wide, narrow));
+    REQUIRE_NOTHROW(nh::widen(narrow, wide));
+    REQUIRE(wide[2] == nh::SafeFloat(2.0f));
+
+    wide[1] = std::numeric_limits<float>::max();
+    REQUIRE_THROWS(nh::narrow(wide, narrow));
+    REQUIRE(narrow[1] == nh::SafeBFloat16(0.0f));
+}
+#endif
@@ -0,0 +1,60 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+
+export module test.expressions;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test lazy expressions")
+{
+    constexpr int32_t Min = std::numeric_limits<int32_t>::min();
+    constexpr int32_t Max = std::numeric_limits<int32_t>::max();
+
+    SECTION("Evaluates like the eager operators")
+    {
+        const SafeI32 a = 3, b = -4, c = 5, d = 6, e = 7;
+        const SafeI32 result = lazy(a) * b + lazy(c) * d - e;
+        REQUIRE(+result == 3 * -4 + 5 * 6 - 7);
+
+        const SafeI64 negated = -(lazy(a) - 10);
+        REQUIRE(+negated == 7);
+    }
+
+    SECTION("Intermediate results may leave the range")
+    {
+        const SafeI32 a = Max, b = Max, c = Min;
+        SafeI32 result = 0;
+        REQUIRE_NOTHROW(result = lazy(a) + b + c + c + 1);
+        REQUIRE(+result == -1);
+        REQUIRE_NOTHROW(result = lazy(a) * b - lazy(a) * b + 1);
+        REQUIRE(+result == 1);
+    }
+
+    SECTION("The result is checked on assignment")
+    {
+        const SafeI32 a = Max, b = 2;
+        REQUIRE_THROWS(SafeI32(lazy(a) * b));
+        REQUIRE(+SafeI64(lazy(a) * b) == 2ll * Max);
+    }
+
+    SECTION("64 bit evaluation converts to unsigned 64 bit")
+    {
+        const SafeU32 a = 5;
+        SafeU64 result = 0;
+        REQUIRE_NOTHROW(result = lazy(a) + 1);
+        REQUIRE(+result == 6);
+        REQUIRE_THROWS(SafeU64(lazy(a) - 6));
+    }
+
+    SECTION("64 bit operands are evaluated in 128 bits")
+    {
+        const SafeI64 a = std::numeric_limits<int64_t>::max();
+        const SafeU64 b = std::numeric_limits<uint64_t>::max();
+        REQUIRE(+SafeI64(lazy(a) * 4 - lazy(a) * 3) == std::numeric_limits<int64_t>::max());
+        REQUIRE(+SafeU64(lazy(b) + 1 - 1) == std::numeric_limits<uint64_t>::max());
+    }
+}
@@ -0,0 +1,164 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+#include <span>
+
+export module test.math;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test checked integer math")
+{
+    constexpr int32_t Min = std::numeric_limits<int32_t>::min();
+    constexpr int32_t Max = std::numeric_limits<int32_t>::max();
+
+    SECTION("abs")
+    {
+        REQUIRE(+abs(SafeI32(-5)) == 5);
+        REQUIRE(+abs(SafeI32(Max)) == Max);
+        REQUIRE_THROWS(abs(SafeI32(Min)));
+    }
+
+    SECTION("pow")
+    {
+        REQUIRE(+pow(SafeI32(3), 0) == 1);
+        REQUIRE(+pow(SafeI32(-2), 31) == Min);
+        REQUIRE(+pow(SafeI64(7), 22) == 3909821048582988049);
+        REQUIRE(+pow(SafeU8(2), 7) == 128);
+        REQUIRE_THROWS(pow(SafeI32(2), 31));
+        REQUIRE_THROWS(pow(SafeU8(2), 8));
+        REQUIRE_THROWS(pow(SafeI32(3), 1000));
+    }
+
+    SECTION("gcd")
+    {
+        REQUIRE(+gcd(SafeI32(12), SafeI32(-18)) == 6);
+        REQUIRE(+gcd(SafeI32(0), SafeI32(7)) == 7);
+        REQUIRE(+gcd(SafeU64(1ull << 40), SafeU64(3ull << 20)) == (1ull << 20));
+        REQUIRE_THROWS(gcd(SafeI32(Min), SafeI32(0)));
+    }
+
+    SECTION("isqrt")
+    {
+        REQUIRE(+isqrt(SafeI32(0)) == 0);
+        REQUIRE(+isqrt(SafeI32(15)) == 3);
+        REQUIRE(+isqrt(SafeI32(16)) == 4);
+        REQUIRE(+isqrt(SafeI32(Max)) == 46340);
+        REQUIRE(+isqrt(SafeU64(std::numeric_limits<uint64_t>::max())) == 4294967295ull);
+        REQUIRE_THROWS(isqrt(SafeI32(-1)));
+    }
+
+    SECTION("midpoint")
+    {
+        REQUIRE(+midpoint(SafeI32(Max), SafeI32(Max - 2)) == Max - 1);
+        REQUIRE(+midpoint(SafeI32(Min), SafeI32(Max)) == -1);
+    }
+
+    SECTION("lerp")
+    {
+        REQUIRE(+lerp(SafeI32(0), SafeI32(10), 1, 3) == 3);
+        REQUIRE(+lerp(SafeI32(10), SafeI32(0), 1, 3) == 7);
+        REQUIRE(+lerp(SafeI32(Min), SafeI32(Max), 1, 2) == +midpoint(SafeI32(Min), SafeI32(Max)));
+        REQUIRE(+lerp(SafeU64(std::numeric_limits<uint64_t>::max()), SafeU64(0), 1, 2) == 1ull << 63);
+        REQUIRE(+lerp(SafeI32(5), SafeI32(7), 3, 2) == 8);
+        REQUIRE_THROWS(lerp(SafeI32(0), SafeI32(Max), 2, 1));
+        REQUIRE_THROWS(lerp(SafeI32(0), SafeI32(1), 1, 0));
+    }
+
+    SECTION("shiftLeft")
+    {
+        REQUIRE(+shiftLeft(SafeI32(-1), 31) == Min);
+        REQUIRE(+shiftLeft(SafeU8(1), 7) == 128);
+        REQUIRE_THROWS(shiftLeft(SafeI32(1), 31));
+        REQUIRE_THROWS(shiftLeft(SafeU8(3), 7));
+        REQUIRE_THROWS(shiftLeft(SafeU8(1), 8));
+    }
+
+    SECTION("Span variants")
+    {
+        SafeI32 values[] = { -4, 9, 16, -25 };
+        abs(std::span<SafeI32>(values));
+        REQUIRE(+values[3] == 25);
+
+        isqrt(std::span<SafeI32>(values));
+        REQUIRE(+values[0] == 2);
+        REQUIRE(+values[3] == 5);
+
+        pow(std::span<SafeI32>(values), 10);
+        REQUIRE(+values[3] == 9765625);
+        REQUIRE_THROWS(pow(std::span<SafeI32>(values), 10));
+
+        const SafeI32 multiples[] = { 12, -18, 30 };
+        REQUIRE(+gcd(std::span<const SafeI32>(multiples)) == 6);
+
+        SafeI32 middle[3];
+        midpoint(std::span<const SafeI32>(multiples), std::span<const SafeI32>(multiples), std::span<SafeI32>(middle));
+        REQUIRE(+middle[1] == -18);
+
+        SafeI32 interpolated[3];
+        lerp(std::span<const SafeI32>(multiples), std::span<const SafeI32>(middle), 1, 4, std::span<SafeI32>(interpolated));
+        REQUIRE(+interpolated[2] == 30);
+        const SafeI32 limits[] = { Max, Max, Max };
+        REQUIRE_THROWS(lerp(std::span<const SafeI32>(multiples), std::span<const SafeI32>(limits), 2, 1, std::span<SafeI32>(interpolated)));
+
+        SafeI32 shifted[] = { -1, 3, 1 << 20 };
+        shiftLeft(std::span<SafeI32>(shifted), 10);
+        REQUIRE(+shifted[0] == -1024);
+        REQUIRE(+shifted[2] == 1 << 30);
+        REQUIRE_THROWS(shiftLeft(std::span<SafeI32>(shifted), 1));
+        REQUIRE_THROWS(shiftLeft(std::span<SafeI32>(shifted), 32));
+    }
+}
+
+TEST_CASE("Test checked decimal math")
+{
+    constexpr double Max = std::numeric_limits<double>::max();
+
+    SECTION("fma")
+    {
+        REQUIRE(+fma(SafeDouble(2.0), SafeDouble(3.0), SafeDouble(1.0)) == 7.0);
+        REQUIRE(+fma(FastFloat(0.5f), FastFloat(4.0f), FastFloat(-1.0f)) == 1.0f);
+        // The product overflows but the fused result is finite.
+        REQUIRE(+fma(SafeDouble(Max), SafeDouble(2.0), SafeDouble(-Max)) == Max);
+        REQUIRE_THROWS(fma(SafeDouble(Max), SafeDouble(2.0), SafeDouble(0.0)));
+        // Single rounding, 0.1 * 10 - 1 is the representation error of 0.1 and not zero.
+        REQUIRE(+fma(SafeDouble(0.1), SafeDouble(10.0), SafeDouble(-1.0)) != 0.0);
+    }
+
+    SECTION("horner")
+    {
+        const SafeDouble coefficients[] = { 1.0, -3.0, 2.0 }; // 1 - 3x + 2x^2
+        REQUIRE(+horner(SafeDouble(0.0), std::span<const SafeDouble>(coefficients)) == 1.0);
+        REQUIRE(+horner(SafeDouble(2.0), std::span<const SafeDouble>(coefficients)) == 3.0);
+        REQUIRE(+horner(SafeDouble(1.0), std::span<const SafeDouble>()) == 0.0);
+        REQUIRE_THROWS(horner(SafeDouble(1e200), std::span<const SafeDouble>(coefficients)));
+
+        const SafeDouble x[] = { 0.0, 1.0, 2.0, 3.0 };
+        SafeDouble result[4];
+        horner(std::span<const SafeDouble>(x), std::span<const SafeDouble>(coefficients), std::span<SafeDouble>(result));
+        REQUIRE(+result[1] == 0.0);
+        REQUIRE(+result[3] == 10.0);
+
+        const SafeDouble large[] = { 1.0, 1e200 };
+        REQUIRE_THROWS(horner(std::span<const SafeDouble>(large), std::span<const SafeDouble>(coefficients), std::span<SafeDouble>(result)));
+        REQUIRE(+result[0] == 0.0);
+    }
+
+    SECTION("dot")
+    {
+        const SafeDouble lhs[] = { 1.0, 2.0, 3.0 };
+        const SafeDouble rhs[] = { 4.0, -5.0, 6.0 };
+        REQUIRE(+dot(std::span<const SafeDouble>(lhs), std::span<const SafeDouble>(rhs)) == 12.0);
+
+        const FastFloat fastLhs[] = { 1.5f, 2.0f };
+        REQUIRE(+dot(std::span<const FastFloat>(fastLhs), std::span<const FastFloat>(fastLhs)) == 6.25f);
+
+        const SafeDouble huge[] = { Max, Max, -Max };
+        const SafeDouble ones[] = { 1.0, 1.0, 1.0 };
+        REQUIRE_THROWS(dot(std::span<const SafeDouble>(huge), std::span<const SafeDouble>(ones)));
+        REQUIRE_THROWS(dot(std::span<const SafeDouble>(lhs), std::span<const SafeDouble>(ones).first(2)));
+    }
+}
@@ -0,0 +1,119 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <span>
+
+export module test.packed;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test SafeUInt and SafeSInt")
+{
+    REQUIRE(SafeUInt<12>::Max == 4095);
+    REQUIRE(SafeSInt<20>::Min == -(1 << 19));
+    REQUIRE(sizeof(SafeUInt<12>) == sizeof(uint16_t));
+
+    REQUIRE_NOTHROW(SafeUInt<3>(7));
+    REQUIRE_THROWS(SafeUInt<3>(8));
+    REQUIRE_THROWS(SafeSInt<4>(-9));
+
+    REQUIRE_THROWS(SafeUInt<3>(7) + SafeUInt<3>(1));
+    REQUIRE_THROWS(SafeUInt<3>(0) - SafeUInt<3>(1));
+    REQUIRE_THROWS(SafeSInt<8>(-128) / SafeSInt<8>(-1));
+    REQUIRE(+(SafeSInt<5>(-4) * SafeSInt<5>(3)) == -12);
+
+    SafeUInt<12> code = 4094;
+    REQUIRE_NOTHROW(code++);
+    REQUIRE_THROWS(++code);
+
+    REQUIRE_THROWS(SafeUInt<32>(4000000000u) * SafeUInt<32>(4000000000u));
+    REQUIRE(+(SafeUInt<32>(65536u) * SafeUInt<32>(65535u)) == 65536ull * 65535);
+    REQUIRE_THROWS(SafeUInt<64>(1ull << 63) * SafeUInt<64>(2u));
+    REQUIRE_THROWS(SafeUInt<64>(0u) - SafeUInt<64>(1u));
+
+    const SafeU16 widened = code;
+    REQUIRE(+widened == 4095);
+    REQUIRE_THROWS(SafeUInt<12>(SafeU16(4096)));
+}
+
+TEST_CASE("Test PackedArray")
+{
+    SECTION("Unsigned values straddling words")
+    {
+        PackedArray<SafeUInt<20>> ids(100);
+        for (size_t i = 0; i < ids.size(); ++i)
+            ids.set(i, SafeUInt<20>(i * 10007 % (1 << 20)));
+
+        REQUIRE(ids.words().size() == (100 * 20 + 63) / 64 + 1);
+        for (size_t i = 0; i < ids.size(); ++i)
+            REQUIRE(+ids[i] == i * 10007 % (1 << 20));
+    }
+
+    SECTION("Signed values")
+    {
+        PackedArray<SafeSInt<7>> values;
+        for (int64_t i = -64; i < 64; ++i)
+            values.push_back(SafeSInt<7>(i));
+
+        for (size_t i = 0; i < values.size(); ++i)
+            REQUIRE(+values[i] == static_cast<int64_t>(i) - 64);
+    }
+
+    SECTION("Bulk pack and unpack")
+    {
+        PackedArray<SafeUInt<3>> flags(10);
+        const uint8_t raw[] = { 1, 2, 3, 4, 5, 6, 7, 0 };
+        flags.pack(2, std::span<const uint8_t>(raw));
+
+        uint8_t unpacked[8] = {};
+        flags.unpack(2, std::span<uint8_t>(unpacked));
+        for (size_t i = 0; i < 8; ++i)
+            REQUIRE(unpacked[i] == raw[i]);
+
+        const uint8_t invalid[] = { 1, 8 };
+        REQUIRE_THROWS(flags.pack(0, std::span<const uint8_t>(invalid)));
+        REQUIRE_THROWS(flags.pack(9, std::span<const uint8_t>(raw)));
+    }
+
+    SECTION("Bulk pack and unpack across words")
+    {
+        PackedArray<SafeSInt<23>> values(40);
+        int32_t raw[37];
+        for (int32_t i = 0; i < 37; ++i)
+            raw[i] = (i % 2 ? -1 : 1) * i * 113;
+        values.set(0, SafeSInt<23>(-5));
+        values.set(39, SafeSInt<23>(7));
+        values.pack(1, std::span<const int32_t>(raw));
+
+        REQUIRE(+values[0] == -5);
+        REQUIRE(+values[38] == 0);
+        REQUIRE(+values[39] == 7);
+        for (size_t i = 0; i < 37; ++i)
+            REQUIRE(+values[i + 1] == raw[i]);
+
+        int32_t unpacked[37] = {};
+        values.unpack(1, std::span<int32_t>(unpacked));
+        for (size_t i = 0; i < 37; ++i)
+            REQUIRE(unpacked[i] == raw[i]);
+
+        PackedArray<SafeUInt<64>> wide(3);
+        const uint64_t full[] = { ~0ull, 1, 1ull << 63 };
+        wide.pack(0, std::span<const uint64_t>(full));
+        REQUIRE(+wide[0] == ~0ull);
+        REQUIRE(+wide[2] == 1ull << 63);
+    }
+
+    SECTION("Shrinking clears the dropped values")
+    {
+        PackedArray<SafeUInt<5>> values;
+        for (int i = 0; i < 30; ++i)
+            values.push_back(SafeUInt<5>(31));
+        values.resize(3);
+        values.resize(30);
+        REQUIRE(+values[2] == 31);
+        for (size_t i = 3; i < values.size(); ++i)
+            REQUIRE(+values[i] == 0);
+    }
+}
@@ -0,0 +1,62 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+#include <source_location>
+#include <string_view>
+
+export module test.profiling;
+
+import nhtypes;
+
+using namespace nh;
+
+#if ENABLE_OVERFLOW_PROFILING
+
+namespace {
+    // Combined statistics of every site recorded on the given line of this file.
+    ProfiledSite siteAt(uint32_t line) {
+        const std::string_view file = std::source_location::current().file_name();
+        ProfiledSite result { file, line, 0, 0, 0.0 };
+        for (ProfiledSite const & site : overflowProfile()) {
+            if (site.file == file && site.line == line) {
+                result.count += site.count;
+                result.maxRangeFraction = site.maxRangeFraction > result.maxRangeFraction ? site.maxRangeFraction : result.maxRangeFraction;
+            }
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Test overflow profiling")
+{
+    constexpr int32_t Max = std::numeric_limits<int32_t>::max();
+    SafeI32 a = 1000;
+    const SafeI32 b = 2;
+
+    SECTION("Binary operator")
+    {
+        uint32_t line = 0;
+        for (int i = 0; i < 3; ++i) {
+            line = __LINE__; const SafeI32 sum = a + b;
+            REQUIRE(+sum == 1002);
+        }
+        REQUIRE(siteAt(line).count == 3);
+    }
+
+    SECTION("Compound assignment")
+    {
+        const uint32_t line = __LINE__; a += SafeI32(Max - 1000);
+        REQUIRE(siteAt(line).count == 1);
+        REQUIRE(siteAt(line).maxRangeFraction == 1.0);
+    }
+
+    SECTION("Converted left hand side")
+    {
+        const uint32_t line = __LINE__; const SafeI32 sum = 1 + a;
+        REQUIRE(+sum == 1001);
+        REQUIRE(siteAt(line).count == 1);
+    }
+}
+
+#endif
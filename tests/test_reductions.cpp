@@ -0,0 +1,73 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+#include <span>
+
+export module test.reductions;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test wide accumulator reductions")
+{
+    constexpr int32_t Max = std::numeric_limits<int32_t>::max();
+
+    SECTION("Block sizes")
+    {
+        REQUIRE(SafeAccumulator<int32_t>::BlockSize == (1ull << 32) - 1);
+        REQUIRE(SafeAccumulator<uint16_t>::BlockSize > (1ull << 47));
+    }
+
+    SECTION("Accumulator")
+    {
+        SafeAccumulator<int32_t> accumulator;
+        accumulator += SafeI32(Max);
+        accumulator += SafeI32(Max);
+        REQUIRE_THROWS(accumulator.result());
+        REQUIRE(+accumulator.result<int64_t>() == 2ll * Max);
+
+        accumulator += SafeI32(-Max);
+        REQUIRE(+accumulator.result() == Max);
+
+        const SafeI32 values[] = { -Max, 5, Max, -5 };
+        accumulator += std::span<const SafeI32>(values);
+        REQUIRE(+accumulator.result() == Max);
+        accumulator += std::span<const SafeI32>(values).first(2);
+        REQUIRE(+accumulator.result() == 5);
+        accumulator += std::span<const SafeI32>(values).subspan(2, 1);
+        REQUIRE_THROWS(accumulator.result());
+        REQUIRE(+accumulator.result<uint64_t>() == 5ull + Max);
+        accumulator += SafeI32(-Max);
+        accumulator += SafeI32(-Max);
+        REQUIRE_THROWS(accumulator.result<uint64_t>());
+    }
+
+    SECTION("Sum")
+    {
+        const SafeU16 values[] = { 65535, 65535, 2 };
+        REQUIRE_THROWS(sum(std::span<const SafeU16>(values)));
+        REQUIRE(+sum<uint32_t>(std::span<const SafeU16>(values)) == 131072);
+
+        const SafeI32 positive[] = { Max, Max, 2 };
+        REQUIRE(+sum<uint64_t>(std::span<const SafeI32>(positive)) == 2ull * Max + 2);
+        const SafeI32 negative[] = { Max, -Max, -1 };
+        REQUIRE_THROWS(sum<uint64_t>(std::span<const SafeI32>(negative)));
+        REQUIRE_THROWS(sum<uint32_t>(std::span<const SafeI32>(negative)));
+    }
+
+    SECTION("Sum of squares and dot product")
+    {
+        const SafeI32 values[] = { -3, 4, 46340 };
+        REQUIRE(+sumOfSquares<int64_t>(std::span<const SafeI32>(values)) == 9 + 16 + 46340ll * 46340);
+        REQUIRE_NOTHROW(sumOfSquares(std::span<const SafeI32>(values).first(2)));
+
+        const SafeI32 large[] = { Max, Max };
+        REQUIRE_THROWS(dot(std::span<const SafeI32>(large), std::span<const SafeI32>(large)));
+        REQUIRE(+dot<int64_t>(std::span<const SafeI32>(values), std::span<const SafeI32>(values)) == 9 + 16 + 46340ll * 46340);
+
+        const SafeI64 wide[] = { std::numeric_limits<int64_t>::min(), 1 };
+        REQUIRE_THROWS(sumOfSquares(std::span<const SafeI64>(wide)));
+    }
+}
@@ -0,0 +1,60 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+export module test.sorting;
+
+import nhtypes;
+
+using namespace nh;
+
+TEST_CASE("Test sort keys")
+{
+    REQUIRE(sortKey(SafeI32(-1)) < sortKey(SafeI32(0)));
+    REQUIRE(sortKey(SafeI32(std::numeric_limits<int32_t>::min())) == 0);
+    REQUIRE(sortKey(FastU8(200)) == 200);
+
+    REQUIRE(sortKey(SafeDouble(-2.0)) < sortKey(SafeDouble(-1.0)));
+    REQUIRE(sortKey(SafeDouble(-0.0)) < sortKey(SafeDouble(0.0)));
+    REQUIRE(sortKey(SafeFloat(1.0f)) < sortKey(SafeFloat(1.5f)));
+    REQUIRE(sortKey(FastFloat(std::numeric_limits<float>::infinity())) < sortKey(FastFloat(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST_CASE("Test radix sort")
+{
+    // Enough elements to split the passes across threads.
+    std::vector<SafeI64> values;
+    std::vector<int64_t> expected;
+    uint64_t state = 12345;
+    for (size_t i = 0; i < (size_t(1) << 18); ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const int64_t value = static_cast<int64_t>(state) >> (i % 40);
+        values.push_back(SafeI64(value));
+        expected.push_back(value);
+    }
+
+    SECTION("Sort")
+    {
+        radixSort(values, 4);
+        std::sort(expected.begin(), expected.end());
+        for (size_t i = 0; i < values.size(); ++i)
+            REQUIRE(+values[i] == expected[i]);
+    }
+
+    SECTION("Argsort")
+    {
+        const std::vector<size_t> indices = argsort(values, 4);
+        for (size_t i = 1; i < indices.size(); ++i)
+            REQUIRE(expected[indices[i - 1]] <= expected[indices[i]]);
+    }
+
+    SECTION("Argsort is stable")
+    {
+        const std::vector<SafeDouble> decimals = { 2.0, -1.0, 2.0, 0.5, -1.0 };
+        const std::vector<size_t> indices = argsort(decimals);
+        REQUIRE(indices == std::vector<size_t> { 1, 4, 3, 0, 2 });
+    }
+}
@@ -0,0 +1,110 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <limits>
+#include <type_traits>
+
+export module test.type_traits;
+
+import nhtypes;
+
+using namespace nh;
+
+// The limits are usable in constant expressions.
+static_assert(+std::numeric_limits<SafeI32>::max() == std::numeric_limits<int32_t>::max());
+static_assert(+std::numeric_limits<SafeU8>::lowest() == 0);
+static_assert(+std::numeric_limits<FastI64>::min() == std::numeric_limits<int64_t>::min());
+static_assert(+std::numeric_limits<SafeDouble>::epsilon() == std::numeric_limits<double>::epsilon());
+static_assert(+std::numeric_limits<SafeFloat>::lowest() == std::numeric_limits<float>::lowest());
+static_assert(+std::numeric_limits<SafeUInt<12>>::max() == 4095);
+
+TEST_CASE("Numeric limits of helium types")
+{
+    SECTION("Integers")
+    {
+        REQUIRE(std::numeric_limits<SafeI32>::is_specialized);
+        REQUIRE(std::numeric_limits<SafeI32>::is_signed);
+        REQUIRE(!std::numeric_limits<FastU16>::is_signed);
+        REQUIRE(std::numeric_limits<SafeU64>::is_integer);
+        REQUIRE(std::numeric_limits<SafeI32>::digits == 31);
+        REQUIRE(+std::numeric_limits<SafeI32>::max() == std::numeric_limits<int32_t>::max());
+        REQUIRE(+std::numeric_limits<SafeI8>::lowest() == -128);
+        REQUIRE(+std::numeric_limits<FastU8>::min() == 0);
+        REQUIRE(std::is_same_v<decltype(std::numeric_limits<SafeI16>::max()), SafeI16>);
+        REQUIRE(!std::numeric_limits<SafeU32>::is_modulo);
+        REQUIRE(std::numeric_limits<FastU32>::is_modulo);
+        REQUIRE(+std::numeric_limits<SafeI32>::infinity() == 0);
+
+        constexpr auto hi = std::numeric_limits<SafeI32>::max();
+        REQUIRE(+hi == std::numeric_limits<int32_t>::max());
+    }
+
+    SECTION("Decimals")
+    {
+        REQUIRE(std::numeric_limits<SafeDouble>::is_specialized);
+        REQUIRE(!std::numeric_limits<SafeDouble>::is_integer);
+        REQUIRE(!std::numeric_limits<SafeDouble>::has_infinity);
+        REQUIRE(!std::numeric_limits<SafeFloat>::has_quiet_NaN);
+        REQUIRE(std::numeric_limits<FastDouble>::has_infinity);
+        REQUIRE(+std::numeric_limits<SafeFloat>::epsilon() == std::numeric_limits<float>::epsilon());
+        REQUIRE(+std::numeric_limits<FastDouble>::infinity() == std::numeric_limits<double>::infinity());
+        REQUIRE(std::is_same_v<decltype(std::numeric_limits<FastFloat>::lowest()), FastFloat>);
+        // Safe decimals don't advertise infinity or NaN but still provide the members.
+        REQUIRE(+std::numeric_limits<SafeDouble>::infinity() == 0.0);
+        REQUIRE(+std::numeric_limits<SafeFloat>::quiet_NaN() == 0.0f);
+    }
+
+    SECTION("Bit width integers")
+    {
+        REQUIRE(std::numeric_limits<SafeUInt<12>>::digits == 12);
+        REQUIRE(std::numeric_limits<SafeSInt<20>>::digits == 19);
+        REQUIRE(+std::numeric_limits<SafeUInt<12>>::max() == 4095);
+        REQUIRE(+std::numeric_limits<SafeSInt<20>>::min() == -(1 << 19));
+        REQUIRE(!std::numeric_limits<SafeUInt<12>>::is_modulo);
+        REQUIRE(std::is_same_v<decltype(std::numeric_limits<SafeUInt<12>>::infinity()), SafeUInt<12>>);
+    }
+}
+
+TEST_CASE("Common type of helium types")
+{
+    REQUIRE(std::is_same_v<std::common_type_t<SafeI8, SafeI32>, SafeI32>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeU16, SafeI32>, SafeI32>);
+    REQUIRE(std::is_same_v<std::common_type_t<FastI32, SafeI32>, SafeI32>);
+    REQUIRE(std::is_same_v<std::common_type_t<FastFloat, FastDouble>, FastDouble>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeFloat, SafeDouble>, SafeDouble>);
+
+    REQUIRE(std::is_same_v<std::common_type_t<SafeUInt<12>, SafeUInt<20>>, SafeUInt<20>>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeUInt<12>, SafeSInt<12>>, SafeSInt<13>>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeSInt<20>, SafeUInt<12>>, SafeSInt<20>>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeUInt<12>, SafeI32>, SafeI32>);
+    REQUIRE(std::is_same_v<std::common_type_t<SafeI64, SafeSInt<40>>, SafeI64>);
+}
+
+TEST_CASE("Make signed and unsigned")
+{
+    REQUIRE(std::is_same_v<make_signed_t<SafeU32>, SafeI32>);
+    REQUIRE(std::is_same_v<make_unsigned_t<FastI64>, FastU64>);
+    REQUIRE(std::is_same_v<make_signed_t<SafeUInt<12>>, SafeSInt<12>>);
+}
+
+TEST_CASE("Arithmetic concepts")
+{
+    REQUIRE(isArithmetic<SafeI32>);
+    REQUIRE(isArithmetic<int>);
+    REQUIRE(isIntegral<FastU8>);
+    REQUIRE(!isIntegral<SafeFloat>);
+    REQUIRE(isFloatingPoint<FastDouble>);
+    REQUIRE(!isArithmetic<Bool>);
+    REQUIRE(isHeliumInteger<SafeUInt<12>>);
+    REQUIRE(isIntegral<SafeSInt<20>>);
+    REQUIRE(isArithmetic<SafeUInt<1>>);
+    REQUIRE(!isFloatingPoint<SafeSInt<20>>);
+}
+
+TEST_CASE("Helium types are plain values")
+{
+    REQUIRE(std::is_trivially_copyable_v<SafeI32>);
+    REQUIRE(std::is_standard_layout_v<FastU64>);
+    REQUIRE(std::is_trivially_copyable_v<SafeDouble>);
+    REQUIRE(sizeof(SafeI16) == sizeof(int16_t));
+}
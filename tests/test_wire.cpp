@@ -0,0 +1,78 @@
+module;
+
+#include "catch2/catch_test_macros.hpp"
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <tuple>
+
+export module test.wire;
+
+import nhtypes;
+
+using namespace nh;
+
+struct PacketHeader {
+    BigEndian<SafeU16> length;
+    BigEndian<SafeUInt<12>> code;
+    LittleEndian<SafeI32> offset;
+    BigEndian<SafeFloat> scale;
+
+    auto fields() const { return std::tie(length, code, offset, scale); }
+};
+
+TEST_CASE("Test wire values")
+{
+    static_assert(sizeof(PacketHeader) == 12 && alignof(PacketHeader) == 1);
+
+    std::byte buffer[16] = {};
+    const unsigned char bytes[] = {
+        0x01, 0x02,             // length 258
+        0x0F, 0xFF,             // code 4095
+        0xFE, 0xFF, 0xFF, 0xFF, // offset -2
+        0x3F, 0xC0, 0x00, 0x00  // scale 1.5
+    };
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+        buffer[i] = static_cast<std::byte>(bytes[i]);
+
+    SECTION("Parse in place")
+    {
+        PacketHeader const * header = wireView<PacketHeader>(std::span<const std::byte>(buffer));
+        REQUIRE(header == reinterpret_cast<PacketHeader const *>(buffer));
+        REQUIRE(+header->length.load() == 258);
+        REQUIRE(+header->code.load() == 4095);
+        REQUIRE(+header->offset.load() == -2);
+        REQUIRE(+header->scale.load() == 1.5f);
+    }
+
+    SECTION("Write in place")
+    {
+        PacketHeader * header = wireView<PacketHeader>(std::span<std::byte>(buffer));
+        REQUIRE(header != nullptr);
+        header->length = SafeU16(0x0A0B);
+        REQUIRE(buffer[0] == std::byte { 0x0A });
+        REQUIRE(buffer[1] == std::byte { 0x0B });
+    }
+
+    SECTION("Validation")
+    {
+        buffer[2] = std::byte { 0x10 }; // code 4096 doesn't fit into 12 bits
+        REQUIRE_FALSE(isValid(*reinterpret_cast<PacketHeader const *>(buffer)));
+        REQUIRE(wireView<PacketHeader>(std::span<const std::byte>(buffer)) == nullptr);
+        REQUIRE(wireView<PacketHeader>(std::span<std::byte>(buffer)) == nullptr);
+        REQUIRE_THROWS(validate(*reinterpret_cast<PacketHeader const *>(buffer)));
+
+        buffer[2] = std::byte { 0x0F };
+        buffer[8] = std::byte { 0x7F }; // scale becomes NaN
+        buffer[9] = std::byte { 0xC0 };
+        REQUIRE(wireView<PacketHeader>(std::span<const std::byte>(buffer)) == nullptr);
+    }
+
+    SECTION("Short buffer")
+    {
+        REQUIRE(wireView<PacketHeader>(std::span<const std::byte>(buffer).first(11)) == nullptr);
+        REQUIRE(wireView<PacketHeader>(std::span<std::byte>(buffer).first(8)) == nullptr);
+        REQUIRE(wireView<PacketHeader>(std::span<const std::byte>()) == nullptr);
+        REQUIRE(wireView<PacketHeader>(std::span<const std::byte>(buffer).first(12)) != nullptr);
+    }
+}